@@ -0,0 +1,64 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/resource.h>
+
+#include "bench.h"
+#include "rbtree.h"
+
+// 같은 소스를 rbtree.o, btree.o(-DRBTREE_BTREE), rbtree-np.o(-DRBTREE_NOPARENT)에 각각 링크해 백엔드를 비교합니다.
+#ifdef RBTREE_BTREE
+#define BACKEND_NAME "btree"
+#elif defined(RBTREE_NOPARENT)
+#define BACKEND_NAME "rbtree-np"
+#else
+#define BACKEND_NAME "rbtree"
+#endif
+
+int main(int argc, char *argv[]) {
+  size_t n = (argc > 1) ? strtoul(argv[1], NULL, 10) : 4000000;
+  if (n == 0) {
+    fprintf(stderr, "usage: %s [n]\n", argv[0]);
+    return 1;
+  }
+
+  uint64_t seed = 47;
+  key_t *keys = malloc(n * sizeof(key_t));
+  node_t **nodes = malloc(n * sizeof(node_t *));
+  key_t *arr = malloc(n * sizeof(key_t));
+  for (size_t i = 0; i < n; ++i) {
+    keys[i] = (key_t)(bench_rand(&seed) & 0x7fffffff);
+  }
+
+  rbtree *t = new_rbtree();
+  uint64_t t0 = bench_now_ns();
+  for (size_t i = 0; i < n; ++i) {
+    nodes[i] = rbtree_insert(t, keys[i]);
+  }
+  uint64_t t1 = bench_now_ns();
+
+  size_t found = 0;
+  for (size_t i = 0; i < n; ++i) {
+    found += rbtree_find(t, keys[bench_rand(&seed) % n]) != NULL;
+  }
+  uint64_t t2 = bench_now_ns();
+
+  rbtree_to_array(t, arr, n);
+  uint64_t t3 = bench_now_ns();
+
+  for (size_t i = 0; i < n; i += 2) {
+    rbtree_erase(t, nodes[i]);
+  }
+  uint64_t t4 = bench_now_ns();
+
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  printf("%-9s n=%zu insert %7.1f  find %7.1f  to_array %5.1f  erase %7.1f ns/op  node %zu B  maxrss %ld MiB\n",
+         BACKEND_NAME, n, (double)(t1 - t0) / n, (double)(t2 - t1) / n, (double)(t3 - t2) / n,
+         (double)(t4 - t3) / ((n + 1) / 2), sizeof(node_t), usage.ru_maxrss / 1024);
+
+  delete_rbtree(t);
+  free(arr);
+  free(nodes);
+  free(keys);
+  return found == n ? 0 : 1;
+}
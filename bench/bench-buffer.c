@@ -0,0 +1,65 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "bench.h"
+#include "rbtree.h"
+
+/**
+ * @brief 삽입 버퍼 크기별로 삽입 처리량과 조회 비용을 측정합니다.
+ *
+ * 조회는 버퍼가 절반쯤 찬 상태에서 측정합니다. 없는 키를 조회하면 버퍼 전체를 훑게 됩니다.
+ */
+static void run(size_t cap, size_t n) {
+  uint64_t seed = 43;
+  key_t *keys = malloc(n * sizeof(key_t));
+  for (size_t i = 0; i < n; ++i) {
+    keys[i] = (key_t)(bench_rand(&seed) & 0x7fffffff);
+  }
+
+  rbtree *t = new_rbtree();
+  rbtree_set_insert_buffer(t, cap);
+
+  uint64_t t0 = bench_now_ns();
+  for (size_t i = 0; i < n; ++i) {
+    rbtree_insert(t, keys[i]);
+  }
+  rbtree_flush(t);
+  uint64_t t1 = bench_now_ns();
+
+  for (size_t i = 0; i < cap / 2; ++i) {
+    rbtree_insert(t, (key_t)(bench_rand(&seed) & 0x7fffffff));
+  }
+
+  size_t found = 0;
+  uint64_t t2 = bench_now_ns();
+  for (size_t i = 0; i < n; ++i) {
+    found += rbtree_find(t, keys[bench_rand(&seed) % n]) != NULL;
+  }
+  uint64_t t3 = bench_now_ns();
+  for (size_t i = 0; i < n; ++i) {
+    found += rbtree_find(t, (key_t)(bench_rand(&seed) & 0x7fffffff)) != NULL;
+  }
+  uint64_t t4 = bench_now_ns();
+
+  printf("%8zu %12.2f %12.1f %12.1f\n", cap, n * 1e3 / (t1 - t0), (double)(t3 - t2) / n,
+         (double)(t4 - t3) / n);
+
+  delete_rbtree(t);
+  free(keys);
+  (void)found;
+}
+
+int main(int argc, char *argv[]) {
+  size_t n = (argc > 1) ? strtoul(argv[1], NULL, 10) : 1000000;
+  if (n == 0) {
+    fprintf(stderr, "usage: %s [n]\n", argv[0]);
+    return 1;
+  }
+
+  const size_t caps[] = {0, 16, 64, 256, 1024, 4096};
+  printf("%8s %12s %12s %12s\n", "buffer", "insert(M/s)", "hit(ns)", "miss(ns)");
+  for (size_t i = 0; i < sizeof(caps) / sizeof(caps[0]); ++i) {
+    run(caps[i], n);
+  }
+  return 0;
+}
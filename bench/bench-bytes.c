@@ -0,0 +1,85 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bench.h"
+#include "rbtree.h"
+
+#define KEY_CAP 64
+
+typedef struct {
+  char bytes[KEY_CAP];
+  size_t len;
+} key_buf_t;
+
+/**
+ * @brief UUID 형식(8-4-4-4-12의 16진수)의 키를 만듭니다.
+ */
+static void make_uuid(key_buf_t *k, uint64_t *seed) {
+  static const char hex[] = "0123456789abcdef";
+  uint64_t hi = bench_rand(seed), lo = bench_rand(seed);
+  char *p = k->bytes;
+  for (int i = 0; i < 32; ++i) {
+    if (i == 8 || i == 12 || i == 16 || i == 20) {
+      *p++ = '-';
+    }
+    uint64_t *src = (i < 16) ? &hi : &lo;
+    *p++ = hex[*src & 0xf];
+    *src >>= 4;
+  }
+  k->len = (size_t)(p - k->bytes);
+}
+
+/**
+ * @brief URL 형식의 키를 만듭니다. 모든 키가 "https://"로 시작합니다.
+ */
+static void make_url(key_buf_t *k, uint64_t *seed) {
+  int len = snprintf(k->bytes, KEY_CAP, "https://www.site%02u.com/item/%u",
+                     (unsigned)(bench_rand(seed) % 64), (unsigned)(bench_rand(seed) % 100000000));
+  k->len = (size_t)len;
+}
+
+static void run(const char *name, void (*make)(key_buf_t *, uint64_t *), size_t n) {
+  uint64_t seed = 41;
+  key_buf_t *keys = malloc(n * sizeof(key_buf_t));
+  for (size_t i = 0; i < n; ++i) {
+    make(&keys[i], &seed);
+  }
+
+  rbtree *t = new_rbtree();
+  uint64_t t0 = bench_now_ns();
+  for (size_t i = 0; i < n; ++i) {
+    rbtree_insert_bytes(t, keys[i].bytes, keys[i].len);
+  }
+  uint64_t t1 = bench_now_ns();
+
+  size_t found = 0;
+  for (size_t i = 0; i < n; ++i) {
+    const key_buf_t *k = &keys[bench_rand(&seed) % n];
+    found += rbtree_find_bytes(t, k->bytes, k->len) != NULL;
+  }
+  uint64_t t2 = bench_now_ns();
+
+  printf("%-6s n=%zu insert %7.1f ns/op  find %7.1f ns/op  (found %zu)\n", name, n,
+         (double)(t1 - t0) / n, (double)(t2 - t1) / n, found);
+
+  delete_rbtree(t);
+  free(keys);
+}
+
+int main(int argc, char *argv[]) {
+  size_t n = (argc > 1) ? strtoul(argv[1], NULL, 10) : 1000000;
+  if (n == 0) {
+    fprintf(stderr, "usage: %s [n]\n", argv[0]);
+    return 1;
+  }
+
+#ifdef RBTREE_BYTES_NO_PREFIX
+  printf("# full key comparison\n");
+#else
+  printf("# inline %d-byte prefix comparison\n", RBTREE_BYTES_PREFIX);
+#endif
+  run("uuid", make_uuid, n);
+  run("url", make_url, n);
+  return 0;
+}
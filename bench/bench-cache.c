@@ -0,0 +1,63 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "bench.h"
+#include "rbtree.h"
+
+/**
+ * @brief Zipf 분포의 조회로 find 캐시 크기별 조회 시간과 적중률을 측정합니다.
+ */
+int main(int argc, char *argv[]) {
+  size_t n = (argc > 1) ? strtoul(argv[1], NULL, 10) : 1000000;
+  double s = (argc > 2) ? strtod(argv[2], NULL) : 0.99;
+  if (n == 0) {
+    fprintf(stderr, "usage: %s [n] [zipf_s]\n", argv[0]);
+    return 1;
+  }
+
+  uint64_t seed = 53;
+  key_t *keys = malloc(n * sizeof(key_t));
+  for (size_t i = 0; i < n; ++i) {
+    keys[i] = (key_t)(bench_rand(&seed) & 0x7fffffff);
+  }
+
+  // 순위 i의 키는 keys[i]이고, keys는 무작위이므로 인기 있는 키가 트리 곳곳에 흩어집니다.
+  const size_t queries = 4 * n;
+  double *cdf = bench_zipf_cdf(n, s);
+  key_t *query = malloc(queries * sizeof(key_t));
+  for (size_t i = 0; i < queries; ++i) {
+    query[i] = keys[bench_zipf(cdf, n, &seed)];
+  }
+  free(cdf);
+
+  rbtree *t = new_rbtree();
+  for (size_t i = 0; i < n; ++i) {
+    rbtree_insert(t, keys[i]);
+  }
+
+  const size_t sizes[] = {0, 256, 4096, 65536};
+  printf("# n=%zu zipf s=%.2f\n", n, s);
+  printf("%8s %10s %10s\n", "slots", "find(ns)", "hit rate");
+  for (size_t k = 0; k < sizeof(sizes) / sizeof(sizes[0]); ++k) {
+    rbtree_set_find_cache(t, sizes[k]);
+
+    size_t found = 0;
+    uint64_t t0 = bench_now_ns();
+    for (size_t i = 0; i < queries; ++i) {
+      found += rbtree_find(t, query[i]) != NULL;
+    }
+    uint64_t t1 = bench_now_ns();
+
+    double rate = 0;
+    if (t->cache != NULL) {
+      rate = (double)t->cache->hits / (double)(t->cache->hits + t->cache->misses);
+    }
+    printf("%8zu %10.1f %9.1f%%\n", sizes[k], (double)(t1 - t0) / queries, rate * 100);
+    (void)found;
+  }
+
+  delete_rbtree(t);
+  free(query);
+  free(keys);
+  return 0;
+}
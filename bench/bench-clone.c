@@ -0,0 +1,68 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bench.h"
+#include "rbtree.h"
+
+/**
+ * @brief rbtree_clone()을 to_array 후 다시 삽입하는 복제, 같은 크기의 memcpy와 비교합니다.
+ */
+int main(int argc, char *argv[]) {
+  size_t n = (argc > 1) ? strtoul(argv[1], NULL, 10) : 1000000;
+  if (n == 0) {
+    fprintf(stderr, "usage: %s [n]\n", argv[0]);
+    return 1;
+  }
+
+  uint64_t seed = 61;
+  rbtree *t = new_rbtree();
+  for (size_t i = 0; i < n; ++i) {
+    rbtree_insert(t, (key_t)(bench_rand(&seed) & 0x7fffffff));
+  }
+
+  key_t *arr = malloc(n * sizeof(key_t));
+  uint64_t t0 = bench_now_ns();
+  rbtree_to_array(t, arr, n);
+  rbtree *r = new_rbtree();
+  for (size_t i = 0; i < n; ++i) {
+    rbtree_insert(r, arr[i]);
+  }
+  uint64_t t1 = bench_now_ns();
+
+  rbtree *c = rbtree_clone(t);
+  uint64_t t2 = bench_now_ns();
+
+  // 복사본은 노드가 연속되어 있으므로 복사본의 복제는 원본 노드의 위치에 영향을 받지 않습니다.
+  uint64_t t8 = bench_now_ns();
+  rbtree *cc = rbtree_clone(c);
+  uint64_t t9 = bench_now_ns();
+
+  node_t *from = malloc(n * sizeof(node_t));
+  node_t *to = malloc(n * sizeof(node_t));
+  memset(from, 1, n * sizeof(node_t));
+  memset(to, 0, n * sizeof(node_t));
+  uint64_t t3 = bench_now_ns();
+  memcpy(to, from, n * sizeof(node_t));
+  uint64_t t4 = bench_now_ns();
+
+  printf("n=%zu  reinsert %6.1f  clone %5.1f  clone of clone %5.1f  memcpy %5.1f ns/node (%d)\n", n,
+         (double)(t1 - t0) / n, (double)(t2 - t1) / n, (double)(t9 - t8) / n, (double)(t4 - t3) / n,
+         to[n / 2].key);
+
+  uint64_t t5 = bench_now_ns();
+  rbtree_to_array(t, arr, n);
+  uint64_t t6 = bench_now_ns();
+  rbtree_to_array(c, arr, n);
+  uint64_t t7 = bench_now_ns();
+  printf("to_array  original %5.1f  clone %5.1f ns/node\n", (double)(t6 - t5) / n, (double)(t7 - t6) / n);
+
+  free(from);
+  free(to);
+  free(arr);
+  delete_rbtree(cc);
+  delete_rbtree(c);
+  delete_rbtree(r);
+  delete_rbtree(t);
+  return 0;
+}
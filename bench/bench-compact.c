@@ -0,0 +1,74 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "bench.h"
+#include "rbtree.h"
+
+/**
+ * @brief 삽입과 삭제를 반복해 노드를 흩어 놓은 뒤, rbtree_compact() 전후의 순회와 조회 시간을 측정합니다.
+ * @param[in] t: 대상 rbtree
+ * @param[in] keys: 조회할 키
+ * @param[in] n: 키의 수
+ * @param[out] arr: to_array에 쓸 배열
+ * @param[in] label: 출력할 이름
+ */
+static void measure(const rbtree *t, const key_t *keys, size_t n, key_t *arr, const char *label) {
+  uint64_t t0 = bench_now_ns();
+  for (int r = 0; r < 5; ++r) {
+    rbtree_to_array(t, arr, n);
+  }
+  uint64_t t1 = bench_now_ns();
+
+  size_t found = 0;
+  for (size_t i = 0; i < n; ++i) {
+    found += rbtree_find(t, keys[i]) != NULL;
+  }
+  uint64_t t2 = bench_now_ns();
+
+  printf("%-8s to_array %5.1f  find %6.1f ns/node (%zu found)\n", label, (double)(t1 - t0) / (5 * n),
+         (double)(t2 - t1) / n, found);
+}
+
+int main(int argc, char *argv[]) {
+  size_t n = (argc > 1) ? strtoul(argv[1], NULL, 10) : 1000000;
+  if (n == 0) {
+    fprintf(stderr, "usage: %s [n]\n", argv[0]);
+    return 1;
+  }
+
+  uint64_t seed = 71;
+  key_t *keys = malloc(n * sizeof(key_t));
+  key_t *arr = malloc(n * sizeof(key_t));
+  rbtree *t = new_rbtree();
+  for (size_t i = 0; i < n; ++i) {
+    keys[i] = (key_t)(bench_rand(&seed) & 0x7fffffff);
+    rbtree_insert(t, keys[i]);
+  }
+
+  // 노드를 하나씩 새로 할당된 노드로 바꿔 힙에 흩어 놓습니다.
+  for (size_t i = 0; i < n; ++i) {
+    const size_t victim = bench_rand(&seed) % n;
+    rbtree_erase(t, rbtree_find(t, keys[victim]));
+    keys[victim] = (key_t)(bench_rand(&seed) & 0x7fffffff);
+    rbtree_insert(t, keys[victim]);
+  }
+
+  for (size_t i = n - 1; i > 0; --i) {
+    const size_t j = bench_rand(&seed) % (i + 1);
+    const key_t k = keys[i];
+    keys[i] = keys[j];
+    keys[j] = k;
+  }
+
+  measure(t, keys, n, arr, "churned");
+  uint64_t t0 = bench_now_ns();
+  rbtree_compact(t);
+  uint64_t t1 = bench_now_ns();
+  printf("compact  %.1f ms (%.1f ns/node)\n", (t1 - t0) / 1e6, (double)(t1 - t0) / n);
+  measure(t, keys, n, arr, "compact");
+
+  delete_rbtree(t);
+  free(arr);
+  free(keys);
+  return 0;
+}
@@ -0,0 +1,48 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/resource.h>
+
+#include "bench.h"
+#include "rbtree.h"
+
+/**
+ * @brief 작은 rbtree를 많이 만들고 지우는 시간과 최대 메모리 사용량을 측정합니다.
+ *
+ * 한 번의 실행은 한 설정만 측정합니다. maxrss는 프로세스 전체의 최댓값이기 때문입니다.
+ */
+int main(int argc, char *argv[]) {
+  if (argc < 2) {
+    fprintf(stderr, "usage: %s <inline_nodes> [trees] [keys]\n", argv[0]);
+    return 1;
+  }
+
+  const size_t slots = strtoul(argv[1], NULL, 10);
+  const size_t trees = (argc > 2) ? strtoul(argv[2], NULL, 10) : 1000000;
+  const size_t keys = (argc > 3) ? strtoul(argv[3], NULL, 10) : 8;
+
+  rbtree **ts = malloc(trees * sizeof(rbtree *));
+  uint64_t seed = 59;
+
+  uint64_t t0 = bench_now_ns();
+  for (size_t i = 0; i < trees; ++i) {
+    ts[i] = (slots > 0) ? new_rbtree_small(slots) : new_rbtree();
+    for (size_t k = 0; k < keys; ++k) {
+      rbtree_insert(ts[i], (key_t)(bench_rand(&seed) & 0xffff));
+    }
+  }
+  uint64_t t1 = bench_now_ns();
+
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+
+  for (size_t i = 0; i < trees; ++i) {
+    delete_rbtree(ts[i]);
+  }
+  uint64_t t2 = bench_now_ns();
+
+  printf("inline=%-3zu trees=%zu keys=%-3zu create %7.1f  destroy %6.1f ns/tree  maxrss %ld MiB\n", slots, trees,
+         keys, (double)(t1 - t0) / trees, (double)(t2 - t1) / trees, usage.ru_maxrss / 1024);
+
+  free(ts);
+  return 0;
+}
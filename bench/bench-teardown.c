@@ -0,0 +1,49 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "bench.h"
+#include "rbtree.h"
+
+static rbtree *build(size_t n, uint64_t *seed) {
+  rbtree *t = new_rbtree();
+  for (size_t i = 0; i < n; ++i) {
+    rbtree_insert(t, (key_t)(bench_rand(seed) & 0x7fffffff));
+  }
+  return t;
+}
+
+/**
+ * @brief delete_rbtree()의 정지 시간과 rbtree_delete_incremental() 호출 한 번의 최대 시간을 비교합니다.
+ */
+int main(int argc, char *argv[]) {
+  size_t n = (argc > 1) ? strtoul(argv[1], NULL, 10) : 4000000;
+  size_t budget = (argc > 2) ? strtoul(argv[2], NULL, 10) : 10000;
+  if (n == 0 || budget == 0) {
+    fprintf(stderr, "usage: %s [n] [budget]\n", argv[0]);
+    return 1;
+  }
+
+  uint64_t seed = 67;
+  rbtree *t = build(n, &seed);
+  uint64_t t0 = bench_now_ns();
+  delete_rbtree(t);
+  uint64_t t1 = bench_now_ns();
+  printf("n=%zu  delete_rbtree %.1f ms\n", n, (t1 - t0) / 1e6);
+
+  t = build(n, &seed);
+  size_t calls = 0;
+  uint64_t total = 0, worst = 0;
+  int more = 1;
+  while (more) {
+    uint64_t a = bench_now_ns();
+    more = rbtree_delete_incremental(t, budget);
+    uint64_t b = bench_now_ns();
+    total += b - a;
+    if (b - a > worst) {
+      worst = b - a;
+    }
+    ++calls;
+  }
+  printf("budget=%zu  %zu calls  total %.1f ms  worst call %.1f us\n", budget, calls, total / 1e6, worst / 1e3);
+  return 0;
+}
@@ -0,0 +1,98 @@
+#ifndef _BENCH_H_
+#define _BENCH_H_
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <time.h>
+
+/**
+ * @brief 단조 증가하는 시계의 현재 시각을 나노초 단위로 반환합니다.
+ */
+static inline uint64_t bench_now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief 재현 가능한 의사 난수를 생성합니다. (xorshift64*)
+ * @param[in,out] state: 0이 아닌 난수 상태
+ */
+static inline uint64_t bench_rand(uint64_t *state) {
+  uint64_t x = *state;
+  x ^= x >> 12;
+  x ^= x << 25;
+  x ^= x >> 27;
+  *state = x;
+  return x * 0x2545F4914F6CDD1Dull;
+}
+
+static int bench_comp_u64__(const void *p1, const void *p2) {
+  const uint64_t e1 = *(const uint64_t *)p1;
+  const uint64_t e2 = *(const uint64_t *)p2;
+  return (e1 > e2) - (e1 < e2);
+}
+
+/**
+ * @brief 측정값을 정렬합니다. bench_percentile() 전에 호출해야 합니다.
+ */
+static inline void bench_sort(uint64_t *samples, size_t n) {
+  qsort(samples, n, sizeof(uint64_t), bench_comp_u64__);
+}
+
+/**
+ * @brief 정렬된 측정값에서 백분위수를 구합니다.
+ * @param[in] sorted: 정렬된 측정값
+ * @param[in] n: 측정값의 개수
+ * @param[in] p: 0 이상 1 이하의 백분위 (예: 0.999)
+ */
+static inline uint64_t bench_percentile(const uint64_t *sorted, size_t n, double p) {
+  if (n == 0) {
+    return 0;
+  }
+
+  size_t idx = (size_t)(p * (double)(n - 1) + 0.5);
+  return sorted[idx < n ? idx : n - 1];
+}
+/**
+ * @brief 순위 0..n-1에 대한 Zipf 분포의 누적 분포를 만듭니다.
+ * @param[in] n: 순위의 수
+ * @param[in] s: 지수, 클수록 분포가 치우칩니다.
+ * @return 길이 n의 누적 분포 배열, 호출한 쪽에서 해제합니다.
+ */
+static inline double *bench_zipf_cdf(size_t n, double s) {
+  double *cdf = malloc(n * sizeof(double));
+  double sum = 0;
+  for (size_t i = 0; i < n; ++i) {
+    sum += 1.0 / pow((double)(i + 1), s);
+    cdf[i] = sum;
+  }
+
+  for (size_t i = 0; i < n; ++i) {
+    cdf[i] /= sum;
+  }
+  return cdf;
+}
+
+/**
+ * @brief Zipf 분포를 따르는 순위를 하나 뽑습니다.
+ * @param[in] cdf: bench_zipf_cdf()로 만든 누적 분포
+ * @param[in] n: 순위의 수
+ * @param[in,out] state: 난수 상태
+ */
+static inline size_t bench_zipf(const double *cdf, size_t n, uint64_t *state) {
+  double u = (double)(bench_rand(state) >> 11) / (double)(1ull << 53);
+  size_t lo = 0, hi = n - 1;
+  while (lo < hi) {
+    size_t mid = lo + (hi - lo) / 2;
+    if (cdf[mid] < u) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+#endif  // _BENCH_H_
@@ -0,0 +1,229 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "bench.h"
+#include "rbtree.h"
+#include "trace.h"
+
+#define OP_COUNT (RBTREE_OP_TO_ARRAY + 1)
+
+static const char *op_names[OP_COUNT] = {"insert", "find", "erase", "min", "max", "to_array"};
+
+typedef struct {
+  rbtree_op_t op;
+  key_t arg;
+} record_t;
+
+/**
+ * @brief 트레이스 파일의 레코드를 모두 메모리로 읽어 들입니다.
+ * @param[in] path: 트레이스 파일 경로
+ * @param[out] len: 읽은 레코드 수
+ * @return 레코드 배열, 실패하면 @b NULL 을 반환합니다.
+ */
+static record_t *load_trace(const char *path, size_t *len) {
+  FILE *stream = fopen(path, "rb");
+  if (stream == NULL) {
+    perror(path);
+    return NULL;
+  }
+
+  if (rbtree_trace_check(stream) != 0) {
+    fprintf(stderr, "%s: not a rbtree trace\n", path);
+    fclose(stream);
+    return NULL;
+  }
+
+  size_t cap = 1024;
+  record_t *recs = malloc(cap * sizeof(record_t));
+  if (recs == NULL) {
+    perror("load_trace");
+    fclose(stream);
+    return NULL;
+  }
+  *len = 0;
+
+  int ret;
+  rbtree_op_t op;
+  key_t arg;
+  while ((ret = rbtree_trace_next(stream, &op, &arg)) == 1) {
+    if (*len == cap) {
+      record_t *grown = realloc(recs, 2 * cap * sizeof(record_t));
+      if (grown == NULL) {
+        perror("load_trace");
+        free(recs);
+        fclose(stream);
+        return NULL;
+      }
+      recs = grown;
+      cap *= 2;
+    }
+    recs[*len].op = op;
+    recs[*len].arg = arg;
+    ++*len;
+  }
+
+  fclose(stream);
+  if (ret < 0) {
+    fprintf(stderr, "%s: corrupted record at %zu\n", path, *len);
+    free(recs);
+    return NULL;
+  }
+
+  return recs;
+}
+
+/**
+ * @brief find 캐시를 거치지 않고 삭제할 노드를 찾습니다.
+ *
+ * 캐시를 잠시 떼어 두므로 캐시의 칸과 적중 횟수에는 트레이스의 find 레코드만 반영됩니다.
+ * @param[in] t: 대상 rbtree
+ * @param[in] key: 키
+ * @return 찾았다면 노드의 포인터를 반환하고 찾지 못했다면 @b NULL 을 반환합니다.
+ */
+static node_t *find_victim(rbtree *t, key_t key) {
+  rbtree_cache_t *cache = t->cache;
+  t->cache = NULL;
+  node_t *victim = rbtree_find(t, key);
+  t->cache = cache;
+  return victim;
+}
+
+/**
+ * @brief 레코드 하나를 rbtree에 수행합니다.
+ * @param[in] t: 대상 rbtree
+ * @param[in] rec: 수행할 레코드
+ * @param[out] buf: to_array에 쓸 버퍼, 길이는 rec->arg 이상이어야 합니다.
+ * @param[in] victim: 삭제 레코드라면 미리 찾아 둔 노드, 없으면 @b NULL
+ */
+static void run_record(rbtree *t, const record_t *rec, key_t *buf, node_t *victim) {
+  switch (rec->op) {
+    case RBTREE_OP_INSERT:
+      rbtree_insert(t, rec->arg);
+      break;
+    case RBTREE_OP_FIND:
+      rbtree_find(t, rec->arg);
+      break;
+    case RBTREE_OP_ERASE:
+      if (victim != NULL) {
+        rbtree_erase(t, victim);
+      }
+      break;
+    case RBTREE_OP_MIN:
+      rbtree_min(t);
+      break;
+    case RBTREE_OP_MAX:
+      rbtree_max(t);
+      break;
+    case RBTREE_OP_TO_ARRAY:
+      rbtree_to_array(t, buf, (size_t)rec->arg);
+      break;
+  }
+}
+
+static void usage(const char *prog) {
+  fprintf(stderr, "usage: %s [-l lazy_ratio] [-b buffer] [-c cache_slots] <trace>\n", prog);
+}
+
+int main(int argc, char *argv[]) {
+  double lazy_ratio = 0;
+  size_t buffer = 0;
+  size_t cache = 0;
+  int opt;
+  while ((opt = getopt(argc, argv, "l:b:c:")) != -1) {
+    switch (opt) {
+      case 'l':
+        lazy_ratio = strtod(optarg, NULL);
+        break;
+      case 'b':
+        buffer = strtoul(optarg, NULL, 10);
+        break;
+      case 'c':
+        cache = strtoul(optarg, NULL, 10);
+        break;
+      default:
+        usage(argv[0]);
+        return 1;
+    }
+  }
+
+  if (optind + 1 != argc) {
+    usage(argv[0]);
+    return 1;
+  }
+
+  size_t len;
+  record_t *recs = load_trace(argv[optind], &len);
+  if (recs == NULL) {
+    return 1;
+  }
+
+  // 측정 중에 할당이 일어나지 않도록 버퍼를 미리 준비합니다.
+  size_t counts[OP_COUNT] = {0};
+  size_t buf_len = 1;
+  for (size_t i = 0; i < len; ++i) {
+    ++counts[recs[i].op];
+    if (recs[i].op == RBTREE_OP_TO_ARRAY && (size_t)recs[i].arg > buf_len) {
+      buf_len = (size_t)recs[i].arg;
+    }
+  }
+
+  uint64_t *lat[OP_COUNT];
+  for (int op = 0; op < OP_COUNT; ++op) {
+    lat[op] = malloc((counts[op] + 1) * sizeof(uint64_t));
+    counts[op] = 0;
+  }
+  key_t *buf = malloc(buf_len * sizeof(key_t));
+
+  rbtree *t = new_rbtree();
+  if (rbtree_set_lazy_erase(t, lazy_ratio) != 0) {
+    fprintf(stderr, "invalid lazy ratio: %g\n", lazy_ratio);
+    return 1;
+  }
+
+  if (rbtree_set_insert_buffer(t, buffer) != 0 || rbtree_set_find_cache(t, cache) != 0) {
+    perror("rbtree");
+    return 1;
+  }
+
+  // 트레이스에는 삭제마다 그 노드를 찾는 find 레코드가 따로 있으므로, 삭제할 노드는 측정 밖에서 찾습니다.
+  uint64_t elapsed = 0;
+  for (size_t i = 0; i < len; ++i) {
+    node_t *victim = NULL;
+    if (recs[i].op == RBTREE_OP_ERASE) {
+      victim = find_victim(t, recs[i].arg);
+    }
+
+    uint64_t t0 = bench_now_ns();
+    run_record(t, &recs[i], buf, victim);
+    uint64_t t1 = bench_now_ns();
+    lat[recs[i].op][counts[recs[i].op]++] = t1 - t0;
+    elapsed += t1 - t0;
+  }
+  if (t->cache != NULL) {
+    printf("find cache: %zu hits, %zu misses\n", t->cache->hits, t->cache->misses);
+  }
+  delete_rbtree(t);
+
+  printf("%-10s %10s %10s %10s %10s\n", "op", "count", "p50(ns)", "p99(ns)", "p999(ns)");
+  for (int op = 0; op < OP_COUNT; ++op) {
+    if (counts[op] == 0) {
+      continue;
+    }
+
+    bench_sort(lat[op], counts[op]);
+    printf("%-10s %10zu %10llu %10llu %10llu\n", op_names[op], counts[op],
+           (unsigned long long)bench_percentile(lat[op], counts[op], 0.50),
+           (unsigned long long)bench_percentile(lat[op], counts[op], 0.99),
+           (unsigned long long)bench_percentile(lat[op], counts[op], 0.999));
+  }
+  printf("total: %zu ops in %.2f ms (%.2f Mops/s)\n", len, elapsed / 1e6,
+         elapsed ? len * 1e3 / elapsed : 0.0);
+
+  for (int op = 0; op < OP_COUNT; ++op) {
+    free(lat[op]);
+  }
+  free(buf);
+  free(recs);
+  return 0;
+}
@@ -0,0 +1,138 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bench.h"
+#include "rbtree.h"
+#include "trace.h"
+
+/**
+ * @brief 무작위 키를 n개 삽입하고, 조회한 뒤 모두 삭제합니다.
+ */
+static void run_uniform(rbtree *t, size_t n, uint64_t *seed) {
+  key_t *keys = malloc(n * sizeof(key_t));
+  for (size_t i = 0; i < n; ++i) {
+    keys[i] = (key_t)(bench_rand(seed) & 0x7fffffff);
+    rbtree_insert(t, keys[i]);
+  }
+
+  // 절반은 존재하는 키, 절반은 존재하지 않을 가능성이 높은 키를 조회합니다.
+  for (size_t i = 0; i < n; ++i) {
+    if (i % 2 == 0) {
+      rbtree_find(t, keys[bench_rand(seed) % n]);
+    } else {
+      rbtree_find(t, (key_t)(bench_rand(seed) & 0x7fffffff));
+    }
+  }
+
+  rbtree_min(t);
+  rbtree_max(t);
+
+  key_t *arr = malloc(n * sizeof(key_t));
+  rbtree_to_array(t, arr, n);
+  free(arr);
+
+  for (size_t i = 0; i < n; ++i) {
+    node_t *p = rbtree_find(t, keys[i]);
+    if (p != NULL) {
+      rbtree_erase(t, p);
+    }
+  }
+
+  free(keys);
+}
+
+/**
+ * @brief 크기 n을 유지하면서 삽입과 삭제를 번갈아 수행합니다.
+ */
+static void run_churn(rbtree *t, size_t n, uint64_t *seed) {
+  key_t *keys = malloc(n * sizeof(key_t));
+  for (size_t i = 0; i < n; ++i) {
+    keys[i] = (key_t)(bench_rand(seed) & 0x7fffffff);
+    rbtree_insert(t, keys[i]);
+  }
+
+  for (size_t i = 0; i < 4 * n; ++i) {
+    size_t victim = bench_rand(seed) % n;
+    node_t *p = rbtree_find(t, keys[victim]);
+    if (p != NULL) {
+      rbtree_erase(t, p);
+    }
+
+    keys[victim] = (key_t)(bench_rand(seed) & 0x7fffffff);
+    rbtree_insert(t, keys[victim]);
+
+    if (i % 64 == 0) {
+      rbtree_min(t);
+    }
+  }
+
+  free(keys);
+}
+
+/**
+ * @brief 키 n개를 삽입한 뒤 Zipf 분포(s = 0.99)로 4n번 조회합니다.
+ */
+static void run_zipf(rbtree *t, size_t n, uint64_t *seed) {
+  key_t *keys = malloc(n * sizeof(key_t));
+  for (size_t i = 0; i < n; ++i) {
+    keys[i] = (key_t)(bench_rand(seed) & 0x7fffffff);
+    rbtree_insert(t, keys[i]);
+  }
+
+  double *cdf = bench_zipf_cdf(n, 0.99);
+  for (size_t i = 0; i < 4 * n; ++i) {
+    rbtree_find(t, keys[bench_zipf(cdf, n, seed)]);
+  }
+
+  free(cdf);
+  free(keys);
+}
+
+static void usage(const char *prog) {
+  fprintf(stderr, "usage: %s <uniform|churn|zipf> <n> <trace> [seed]\n", prog);
+}
+
+int main(int argc, char *argv[]) {
+  if (argc < 4) {
+    usage(argv[0]);
+    return 1;
+  }
+
+  size_t n = strtoul(argv[2], NULL, 10);
+  uint64_t seed = (argc > 4) ? strtoull(argv[4], NULL, 10) : 17;
+  if (n == 0 || seed == 0) {
+    usage(argv[0]);
+    return 1;
+  }
+
+  void (*run)(rbtree *, size_t, uint64_t *) = NULL;
+  if (strcmp(argv[1], "uniform") == 0) {
+    run = run_uniform;
+  } else if (strcmp(argv[1], "churn") == 0) {
+    run = run_churn;
+  } else if (strcmp(argv[1], "zipf") == 0) {
+    run = run_zipf;
+  } else {
+    usage(argv[0]);
+    return 1;
+  }
+
+  FILE *stream = fopen(argv[3], "wb");
+  if (stream == NULL || rbtree_trace_begin(stream) != 0) {
+    perror(argv[3]);
+    return 1;
+  }
+
+  // 실제 rbtree에 워크로드를 수행하면서 hook으로 트레이스를 기록합니다.
+  rbtree *t = new_rbtree();
+  rbtree_set_hook(t, rbtree_trace_hook, stream);
+  run(t, n, &seed);
+  delete_rbtree(t);
+
+  if (rbtree_trace_end(stream) != 0) {
+    fprintf(stderr, "%s: failed to write trace\n", argv[3]);
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,632 @@
+// rbtree.h의 인터페이스를 B-tree로 구현한 백엔드입니다.
+// 노드 하나의 탐색에 필요한 키, 키 수, 자식 번호를 캐시 라인 하나에 모아, 한 수준을 내려갈 때 캐시 라인을
+// 하나만 읽습니다. 핸들은 같은 노드의 다음 라인에 두어 키를 찾았을 때만 읽습니다.
+// rbtree.c 대신 이 파일을 링크하고, 모든 소스를 -DRBTREE_BTREE로 컴파일해야 합니다.
+#ifndef RBTREE_BTREE
+#define RBTREE_BTREE
+#endif
+#include "rbtree.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+// 최소 차수 t. 루트가 아닌 노드는 t-1 ~ 2t-1개의 키를 가집니다.
+#define BTREE_MIN_DEGREE 4
+#define BTREE_MAX_KEYS (2 * BTREE_MIN_DEGREE - 1)
+
+// 노드는 chunk 단위로 할당하고 32비트 번호로 가리킵니다. chunk는 옮기지 않으므로 노드 포인터도 바뀌지 않습니다.
+#define BTREE_CHUNK_BITS 10
+#define BTREE_CHUNK_NODES (1u << BTREE_CHUNK_BITS)
+#define BTREE_NONE UINT32_MAX
+
+// 첫 캐시 라인: 키 7개, 키 수, 리프 여부, 자식 번호 8개
+// 둘째 캐시 라인: 키의 핸들. 같은 키가 여러 개일 수 있으므로 항목은 (키, 핸들 주소) 순서로 정렬합니다.
+struct btree_node_t {
+  _Alignas(64) key_t keys[BTREE_MAX_KEYS];
+  uint8_t n;
+  uint8_t leaf;
+  uint32_t children[BTREE_MAX_KEYS + 1];  // 빈 노드 목록에서는 children[0]이 다음 빈 노드의 번호입니다.
+  node_t *items[BTREE_MAX_KEYS];
+};
+
+_Static_assert(offsetof(struct btree_node_t, items) == 64, "search fields must fit one cache line");
+
+struct btree_arena_t {
+  btree_node_t **chunks;
+  uint32_t nchunks;
+  uint32_t used;  // 한 번이라도 쓴 번호의 수
+  uint32_t free;  // 빈 노드 목록의 첫 번호
+};
+
+static inline btree_node_t *btree_at__(const btree_arena_t *a, uint32_t id) {
+  return &a->chunks[id >> BTREE_CHUNK_BITS][id & (BTREE_CHUNK_NODES - 1)];
+}
+
+/**
+ * @brief 힙에 새로운 rbtree를 생성하고 0으로 초기화합니다.
+ * @return 생성된 rbtree의 포인터를 반환합니다.
+ */
+rbtree *new_rbtree(void) {
+  rbtree *t = (rbtree *)calloc(1, sizeof(rbtree));
+  if (t == NULL) {
+    return NULL;
+  }
+
+  t->arena = (btree_arena_t *)calloc(1, sizeof(btree_arena_t));
+  if (t->arena == NULL) {
+    free(t);
+    return NULL;
+  }
+
+  t->arena->free = BTREE_NONE;
+  t->root_id = BTREE_NONE;
+  return t;
+}
+
+/**
+ * @brief 빈 B-tree 노드를 하나 꺼냅니다.
+ * @param[in] a: 노드 저장소
+ * @param[in] leaf: 리프 노드 여부
+ * @return 노드의 번호를 반환하고, 할당에 실패하면 BTREE_NONE을 반환합니다.
+ */
+static uint32_t new_bnode__(btree_arena_t *a, int leaf) {
+  uint32_t id = a->free;
+  if (id != BTREE_NONE) {
+    a->free = btree_at__(a, id)->children[0];
+  } else {
+    if ((a->used >> BTREE_CHUNK_BITS) == a->nchunks) {
+      btree_node_t **chunks = (btree_node_t **)realloc(a->chunks, (a->nchunks + 1) * sizeof(btree_node_t *));
+      if (chunks == NULL) {
+        return BTREE_NONE;
+      }
+      a->chunks = chunks;
+
+      btree_node_t *chunk =
+          (btree_node_t *)aligned_alloc(_Alignof(btree_node_t), BTREE_CHUNK_NODES * sizeof(btree_node_t));
+      if (chunk == NULL) {
+        return BTREE_NONE;
+      }
+      a->chunks[a->nchunks++] = chunk;
+    }
+    id = a->used++;
+  }
+
+  btree_node_t *x = btree_at__(a, id);
+  memset(x, 0, sizeof(btree_node_t));
+  x->leaf = (uint8_t)leaf;
+  return id;
+}
+
+/**
+ * @brief 노드를 빈 노드 목록으로 돌려보냅니다.
+ * @param[in] a: 노드 저장소
+ * @param[in] id: 노드의 번호
+ */
+static void delete_bnode__(btree_arena_t *a, uint32_t id) {
+  btree_at__(a, id)->children[0] = a->free;
+  a->free = id;
+}
+
+/**
+ * @brief 서브트리의 핸들을 모두 해제합니다. 노드는 chunk와 함께 해제됩니다.
+ * @param[in] a: 노드 저장소
+ * @param[in] x: 서브트리의 루트
+ */
+static void delete_items__(const btree_arena_t *a, const btree_node_t *x) {
+  for (int i = 0; i < x->n; ++i) {
+    free(x->items[i]);
+  }
+
+  if (!x->leaf) {
+    for (int i = 0; i <= x->n; ++i) {
+      delete_items__(a, btree_at__(a, x->children[i]));
+    }
+  }
+}
+
+/**
+ * @brief rbtree를 삭제합니다.
+ * @param[in] t: 삭제할 rbtree
+ */
+void delete_rbtree(rbtree *t) {
+  btree_arena_t *a = t->arena;
+  if (t->root != NULL) {
+    delete_items__(a, t->root);
+  }
+
+  for (uint32_t i = 0; i < a->nchunks; ++i) {
+    free(a->chunks[i]);
+  }
+  free(a->chunks);
+  free(a);
+  free(t);
+}
+
+/**
+ * @brief rbtree에 연산 hook을 등록합니다.
+ * @param[in] t: 대상 rbtree
+ * @param[in] hook: 연산마다 호출할 함수, @b NULL 이면 hook을 해제합니다.
+ * @param[in] ctx: hook에 그대로 전달할 값
+ */
+void rbtree_set_hook(rbtree *t, rbtree_hook_t hook, void *ctx) {
+  t->hook = hook;
+  t->hook_ctx = ctx;
+}
+
+static inline void rbtree_notify__(const rbtree *t, rbtree_op_t op, key_t arg) {
+  if (t->hook != NULL) {
+    t->hook(t->hook_ctx, op, arg);
+  }
+}
+
+static inline void btree_set_root__(rbtree *t, uint32_t id) {
+  t->root_id = id;
+  t->root = (id == BTREE_NONE) ? NULL : btree_at__(t->arena, id);
+}
+
+/**
+ * @brief 노드에서 key보다 작은 키의 수를 셉니다. 키가 정렬되어 있으므로 lower bound와 같습니다.
+ * @param[in] x: 대상 노드
+ * @param[in] key: 키
+ */
+static inline int btree_count_less__(const btree_node_t *x, key_t key) {
+#ifdef __SSE2__
+  // 키 칸 8개를 두 번에 비교합니다. 여덟째 칸은 키 수와 겹치므로 키 수 밖의 결과와 함께 버립니다.
+  const __m128i k = _mm_set1_epi32(key);
+  __m128i lo = _mm_load_si128((const __m128i *)&x->keys[0]);
+  __m128i hi = _mm_load_si128((const __m128i *)&x->keys[4]);
+  int mask = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmplt_epi32(lo, k))) |
+             (_mm_movemask_ps(_mm_castsi128_ps(_mm_cmplt_epi32(hi, k))) << 4);
+  return __builtin_popcount(mask & ((1 << x->n) - 1));
+#else
+  int i = 0;
+  while (i < x->n && x->keys[i] < key) {
+    ++i;
+  }
+  return i;
+#endif
+}
+
+/**
+ * @brief 노드에서 (key, p) 이상인 첫 항목의 인덱스를 찾습니다.
+ * @param[in] x: 대상 노드
+ * @param[in] key: 키
+ * @param[in] p: 핸들
+ */
+static inline int btree_lower_bound__(const btree_node_t *x, key_t key, const node_t *p) {
+  int i = btree_count_less__(x, key);
+  while (i < x->n && x->keys[i] == key && (uintptr_t)x->items[i] < (uintptr_t)p) {
+    ++i;
+  }
+
+  return i;
+}
+
+/**
+ * @brief 가득 찬 자식 노드를 둘로 나누고 가운데 항목을 부모로 올립니다.
+ * @param[in] a: 노드 저장소
+ * @param[in] x: 부모 노드, 가득 차 있지 않아야 합니다.
+ * @param[in] i: 나눌 자식의 인덱스
+ */
+static int btree_split_child__(btree_arena_t *a, btree_node_t *x, int i) {
+  const int t = BTREE_MIN_DEGREE;
+  btree_node_t *y = btree_at__(a, x->children[i]);
+  uint32_t zid = new_bnode__(a, y->leaf);
+  if (zid == BTREE_NONE) {
+    return -1;
+  }
+  btree_node_t *z = btree_at__(a, zid);
+
+  z->n = t - 1;
+  memcpy(z->keys, &y->keys[t], (t - 1) * sizeof(key_t));
+  memcpy(z->items, &y->items[t], (t - 1) * sizeof(node_t *));
+  if (!y->leaf) {
+    memcpy(z->children, &y->children[t], t * sizeof(uint32_t));
+  }
+  y->n = t - 1;
+
+  memmove(&x->children[i + 2], &x->children[i + 1], (x->n - i) * sizeof(uint32_t));
+  x->children[i + 1] = zid;
+  memmove(&x->keys[i + 1], &x->keys[i], (x->n - i) * sizeof(key_t));
+  memmove(&x->items[i + 1], &x->items[i], (x->n - i) * sizeof(node_t *));
+  x->keys[i] = y->keys[t - 1];
+  x->items[i] = y->items[t - 1];
+  x->n++;
+
+  return 0;
+}
+
+/**
+ * @brief 새로운 키를 rbtree에 삽입합니다. 내려가는 길의 가득 찬 노드는 미리 나눕니다.
+ * @param[in] t: 대상 rbtree
+ * @param[in] key: 키
+ * @return 삽입한 키의 핸들을 반환합니다.
+ */
+node_t *rbtree_insert(rbtree *t, const key_t key) {
+  rbtree_notify__(t, RBTREE_OP_INSERT, key);
+
+  node_t *p = (node_t *)malloc(sizeof(node_t));
+  if (p == NULL) {
+    return NULL;
+  }
+  p->key = key;
+
+  btree_arena_t *a = t->arena;
+  if (t->root == NULL) {
+    uint32_t id = new_bnode__(a, 1);
+    if (id == BTREE_NONE) {
+      free(p);
+      return NULL;
+    }
+    btree_set_root__(t, id);
+  } else if (t->root->n == BTREE_MAX_KEYS) {
+    uint32_t sid = new_bnode__(a, 0);
+    if (sid == BTREE_NONE) {
+      free(p);
+      return NULL;
+    }
+
+    btree_node_t *s = btree_at__(a, sid);
+    s->children[0] = t->root_id;
+    if (btree_split_child__(a, s, 0) != 0) {
+      delete_bnode__(a, sid);
+      free(p);
+      return NULL;
+    }
+    btree_set_root__(t, sid);
+  }
+
+  btree_node_t *x = t->root;
+  while (1) {
+    int i = btree_lower_bound__(x, key, p);
+    if (x->leaf) {
+      memmove(&x->keys[i + 1], &x->keys[i], (x->n - i) * sizeof(key_t));
+      memmove(&x->items[i + 1], &x->items[i], (x->n - i) * sizeof(node_t *));
+      x->keys[i] = key;
+      x->items[i] = p;
+      x->n++;
+      break;
+    }
+
+    if (btree_at__(a, x->children[i])->n == BTREE_MAX_KEYS) {
+      if (btree_split_child__(a, x, i) != 0) {
+        free(p);
+        return NULL;
+      }
+
+      if (x->keys[i] < key || (x->keys[i] == key && (uintptr_t)x->items[i] < (uintptr_t)p)) {
+        ++i;
+      }
+    }
+    x = btree_at__(a, x->children[i]);
+  }
+
+  t->size++;
+  return p;
+}
+
+/**
+ * @brief rbtree에 키가 같은 항목을 찾습니다.
+ * @param[in] t: 대상 rbtree
+ * @param[in] key: 키
+ * @return 찾았다면 핸들을 반환하고 찾지 못했다면 @b NULL 을 반환합니다.
+ */
+node_t *rbtree_find(const rbtree *t, const key_t key) {
+  rbtree_notify__(t, RBTREE_OP_FIND, key);
+
+  const btree_node_t *x = t->root;
+  while (x != NULL) {
+    int i = btree_count_less__(x, key);
+    if (i < x->n && x->keys[i] == key) {
+      return x->items[i];
+    }
+
+    if (x->leaf) {
+      return NULL;
+    }
+    x = btree_at__(t->arena, x->children[i]);
+  }
+
+  return NULL;
+}
+
+/**
+ * @brief 최솟값을 찾습니다.
+ * @param[in] t: 대상 rbtree
+ * @return 최솟값의 핸들을 반환하고, 비어 있다면 @b NULL 을 반환합니다.
+ */
+node_t *rbtree_min(const rbtree *t) {
+  rbtree_notify__(t, RBTREE_OP_MIN, 0);
+
+  const btree_node_t *x = t->root;
+  if (x == NULL) {
+    return NULL;
+  }
+
+  while (!x->leaf) {
+    x = btree_at__(t->arena, x->children[0]);
+  }
+
+  return x->items[0];
+}
+
+/**
+ * @brief 최댓값을 찾습니다.
+ * @param[in] t: 대상 rbtree
+ * @return 최댓값의 핸들을 반환하고, 비어 있다면 @b NULL 을 반환합니다.
+ */
+node_t *rbtree_max(const rbtree *t) {
+  rbtree_notify__(t, RBTREE_OP_MAX, 0);
+
+  const btree_node_t *x = t->root;
+  if (x == NULL) {
+    return NULL;
+  }
+
+  while (!x->leaf) {
+    x = btree_at__(t->arena, x->children[x->n]);
+  }
+
+  return x->items[x->n - 1];
+}
+
+/**
+ * @brief 자식 i, 항목 i, 자식 i + 1을 자식 i 하나로 합칩니다.
+ * @param[in] a: 노드 저장소
+ * @param[in] x: 부모 노드
+ * @param[in] i: 합칠 항목의 인덱스
+ */
+static void btree_merge__(btree_arena_t *a, btree_node_t *x, int i) {
+  btree_node_t *y = btree_at__(a, x->children[i]);
+  const uint32_t zid = x->children[i + 1];
+  btree_node_t *z = btree_at__(a, zid);
+
+  y->keys[y->n] = x->keys[i];
+  y->items[y->n] = x->items[i];
+  memcpy(&y->keys[y->n + 1], z->keys, z->n * sizeof(key_t));
+  memcpy(&y->items[y->n + 1], z->items, z->n * sizeof(node_t *));
+  if (!y->leaf) {
+    memcpy(&y->children[y->n + 1], z->children, (z->n + 1) * sizeof(uint32_t));
+  }
+  y->n += z->n + 1;
+
+  memmove(&x->keys[i], &x->keys[i + 1], (x->n - i - 1) * sizeof(key_t));
+  memmove(&x->items[i], &x->items[i + 1], (x->n - i - 1) * sizeof(node_t *));
+  memmove(&x->children[i + 1], &x->children[i + 2], (x->n - i - 1) * sizeof(uint32_t));
+  x->n--;
+
+  delete_bnode__(a, zid);
+}
+
+/**
+ * @brief 왼쪽 형제의 마지막 항목을 부모를 거쳐 자식 i의 맨 앞으로 옮깁니다.
+ * @param[in] a: 노드 저장소
+ * @param[in] x: 부모 노드
+ * @param[in] i: 항목을 받을 자식의 인덱스
+ */
+static void btree_borrow_left__(btree_arena_t *a, btree_node_t *x, int i) {
+  btree_node_t *c = btree_at__(a, x->children[i]);
+  btree_node_t *l = btree_at__(a, x->children[i - 1]);
+
+  memmove(&c->keys[1], c->keys, c->n * sizeof(key_t));
+  memmove(&c->items[1], c->items, c->n * sizeof(node_t *));
+  if (!c->leaf) {
+    memmove(&c->children[1], c->children, (c->n + 1) * sizeof(uint32_t));
+    c->children[0] = l->children[l->n];
+  }
+  c->keys[0] = x->keys[i - 1];
+  c->items[0] = x->items[i - 1];
+  c->n++;
+
+  x->keys[i - 1] = l->keys[l->n - 1];
+  x->items[i - 1] = l->items[l->n - 1];
+  l->n--;
+}
+
+/**
+ * @brief 오른쪽 형제의 첫 항목을 부모를 거쳐 자식 i의 맨 뒤로 옮깁니다.
+ * @param[in] a: 노드 저장소
+ * @param[in] x: 부모 노드
+ * @param[in] i: 항목을 받을 자식의 인덱스
+ */
+static void btree_borrow_right__(btree_arena_t *a, btree_node_t *x, int i) {
+  btree_node_t *c = btree_at__(a, x->children[i]);
+  btree_node_t *r = btree_at__(a, x->children[i + 1]);
+
+  c->keys[c->n] = x->keys[i];
+  c->items[c->n] = x->items[i];
+  if (!c->leaf) {
+    c->children[c->n + 1] = r->children[0];
+    memmove(r->children, &r->children[1], r->n * sizeof(uint32_t));
+  }
+  c->n++;
+
+  x->keys[i] = r->keys[0];
+  x->items[i] = r->items[0];
+  memmove(r->keys, &r->keys[1], (r->n - 1) * sizeof(key_t));
+  memmove(r->items, &r->items[1], (r->n - 1) * sizeof(node_t *));
+  r->n--;
+}
+
+/**
+ * @brief 서브트리에서 항목 (key, p)를 삭제합니다. 내려가는 노드가 항상 t개 이상의 키를 갖도록 미리 채웁니다.
+ * @param[in] a: 노드 저장소
+ * @param[in] x: 서브트리의 루트
+ * @param[in] key: 키
+ * @param[in] p: 핸들
+ * @return 삭제했다면 0, 항목이 없다면 -1을 반환합니다.
+ */
+static int btree_delete__(btree_arena_t *a, btree_node_t *x, key_t key, node_t *p) {
+  const int t = BTREE_MIN_DEGREE;
+  while (1) {
+    int i = btree_lower_bound__(x, key, p);
+    if (i < x->n && x->items[i] == p) {
+      if (x->leaf) {
+        memmove(&x->keys[i], &x->keys[i + 1], (x->n - i - 1) * sizeof(key_t));
+        memmove(&x->items[i], &x->items[i + 1], (x->n - i - 1) * sizeof(node_t *));
+        x->n--;
+        return 0;
+      }
+
+      btree_node_t *y = btree_at__(a, x->children[i]);
+      btree_node_t *z = btree_at__(a, x->children[i + 1]);
+      if (y->n >= t) {
+        // 직전 항목으로 바꾸고, 직전 항목을 왼쪽 서브트리에서 삭제합니다.
+        btree_node_t *c = y;
+        while (!c->leaf) {
+          c = btree_at__(a, c->children[c->n]);
+        }
+        key = x->keys[i] = c->keys[c->n - 1];
+        p = x->items[i] = c->items[c->n - 1];
+        x = y;
+        continue;
+      }
+
+      if (z->n >= t) {
+        btree_node_t *c = z;
+        while (!c->leaf) {
+          c = btree_at__(a, c->children[0]);
+        }
+        key = x->keys[i] = c->keys[0];
+        p = x->items[i] = c->items[0];
+        x = z;
+        continue;
+      }
+
+      btree_merge__(a, x, i);
+      x = y;
+      continue;
+    }
+
+    if (x->leaf) {
+      return -1;
+    }
+
+    btree_node_t *c = btree_at__(a, x->children[i]);
+    if (c->n < t) {
+      if (i > 0 && btree_at__(a, x->children[i - 1])->n >= t) {
+        btree_borrow_left__(a, x, i);
+      } else if (i < x->n && btree_at__(a, x->children[i + 1])->n >= t) {
+        btree_borrow_right__(a, x, i);
+      } else if (i < x->n) {
+        btree_merge__(a, x, i);
+      } else {
+        btree_merge__(a, x, i - 1);
+        c = btree_at__(a, x->children[i - 1]);
+      }
+    }
+    x = c;
+  }
+}
+
+/**
+ * @brief 핸들이 가리키는 항목을 삭제하고 핸들을 해제합니다.
+ * @param[in] t: 대상 rbtree
+ * @param[in] p: 대상 핸들
+ * @return 성공하면 0, rbtree에 없는 핸들이라면 -1을 반환합니다.
+ */
+int rbtree_erase(rbtree *t, node_t *p) {
+  rbtree_notify__(t, RBTREE_OP_ERASE, p->key);
+
+  if (t->root == NULL || btree_delete__(t->arena, t->root, p->key, p) != 0) {
+    return -1;
+  }
+
+  // 루트의 키가 모두 내려갔다면 높이를 하나 줄입니다.
+  btree_node_t *root = t->root;
+  if (root->n == 0) {
+    const uint32_t id = t->root_id;
+    btree_set_root__(t, root->leaf ? BTREE_NONE : root->children[0]);
+    delete_bnode__(t->arena, id);
+  }
+
+  t->size--;
+  free(p);
+  return 0;
+}
+
+/**
+ * @brief 서브트리를 중위 순회 순서로 배열에 씁니다.
+ * @param[in] a: 노드 저장소
+ * @param[in] x: 서브트리의 루트
+ * @param[out] arr: 키를 저장할 배열
+ * @param[in] idx: 배열의 현재 인덱스
+ * @param[in] len: 배열의 길이
+ * @return 다음에 쓸 배열의 인덱스를 반환합니다.
+ */
+static size_t btree_to_array_inorder__(const btree_arena_t *a, const btree_node_t *x, key_t *arr, size_t idx,
+                                       const size_t len) {
+  for (int i = 0; i <= x->n && idx < len; ++i) {
+    if (!x->leaf) {
+      idx = btree_to_array_inorder__(a, btree_at__(a, x->children[i]), arr, idx, len);
+    }
+
+    if (i < x->n && idx < len) {
+      arr[idx++] = x->keys[i];
+    }
+  }
+
+  return idx;
+}
+
+/**
+ * @brief rbtree를 중위 순회 순서로 배열에 씁니다.
+ * @param[in] t: 대상 rbtree
+ * @param[out] arr: 키를 순서대로 저장할 배열
+ * @param[in] n: 배열의 길이
+ */
+int rbtree_to_array(const rbtree *t, key_t *arr, const size_t n) {
+  rbtree_notify__(t, RBTREE_OP_TO_ARRAY, (n > INT32_MAX) ? INT32_MAX : (key_t)n);
+
+  if (t->root != NULL) {
+    btree_to_array_inorder__(t->arena, t->root, arr, 0, n);
+  }
+  return 0;
+}
+
+/**
+ * @brief 서브트리를 전위 순회 순서로 스트림에 출력합니다.
+ * @param[out] stream: 대상 stream
+ * @param[in] a: 노드 저장소
+ * @param[in] x: 현재 노드
+ * @param[in] indent: 현재 수준
+ */
+static void btree_print_preorder__(FILE *stream, const btree_arena_t *a, const btree_node_t *x, size_t indent) {
+  for (size_t i = 0; i < indent; ++i) {
+    fprintf(stream, " ");
+  }
+
+  fprintf(stream, "[");
+  for (int i = 0; i < x->n; ++i) {
+    fprintf(stream, (i == 0) ? "%d" : " %d", x->keys[i]);
+  }
+  fprintf(stream, "]\n");
+
+  if (!x->leaf) {
+    for (int i = 0; i <= x->n; ++i) {
+      btree_print_preorder__(stream, a, btree_at__(a, x->children[i]), indent + 4);
+    }
+  }
+}
+
+/**
+ * @brief rbtree를 스트림에 출력합니다.
+ * @param[out] stream: 대상 stream
+ * @param[in] t: 대상 rbtree
+ */
+int rbtree_print(FILE *stream, const rbtree *t) {
+  if (stream == NULL) {
+    return -1;
+  }
+
+  if (t->root != NULL) {
+    btree_print_preorder__(stream, t->arena, t->root, 0);
+  }
+  return 0;
+}
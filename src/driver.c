@@ -1,14 +1,32 @@
 #include "rbtree.h"
+#include "trace.h"
 
 int main(int argc, char *argv[]) {
   const key_t arr[] = {10, 5, 8, 34, 67, 23, 156, 24, 2, 12, 24, 36, 990, 25};
   const size_t n = sizeof(arr) / sizeof(arr[0]);
   rbtree *t = new_rbtree();
 
+  // driver <trace>: 수행한 연산을 트레이스 파일로 기록합니다.
+  FILE *trace = NULL;
+  if (argc > 1) {
+    trace = fopen(argv[1], "wb");
+    if (trace == NULL || rbtree_trace_begin(trace) != 0) {
+      perror(argv[1]);
+      return 1;
+    }
+    rbtree_set_hook(t, rbtree_trace_hook, trace);
+  }
+
   for (size_t i = 0; i < n; ++i) {
     rbtree_insert(t, arr[i]);
   }
 
   rbtree_print(stdout, t);
   delete_rbtree(t);
-}
\ No newline at end of file
+
+  if (trace != NULL && rbtree_trace_end(trace) != 0) {
+    fprintf(stderr, "%s: failed to write trace\n", argv[1]);
+    return 1;
+  }
+  return 0;
+}
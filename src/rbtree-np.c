@@ -0,0 +1,391 @@
+// rbtree.h의 인터페이스를 부모 포인터 없이 구현한 변형입니다.
+// 내려가며 지나온 노드를 스택에 쌓아 두고, 균형은 그 스택을 거꾸로 올라가며 맞춥니다.
+// rbtree.c 대신 이 파일을 링크하고, 모든 소스를 -DRBTREE_NOPARENT로 컴파일해야 합니다.
+#ifndef RBTREE_NOPARENT
+#define RBTREE_NOPARENT
+#endif
+#include "rbtree.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+
+// 노드가 n개인 rbtree의 높이는 2 log2(n + 1) 이하이므로 64비트 주소 공간에서 128을 넘지 않습니다.
+// 삭제 중 회전 한 번으로 경로가 한 칸 늘어날 수 있어 여유를 둡니다.
+#define RBTREE_NP_MAX_DEPTH 130
+
+// 모든 rbtree가 함께 쓰는 sentinel. 어떤 연산도 이 노드에 쓰지 않습니다.
+static node_t rbtree_nil__ = {.color = RBTREE_BLACK};
+
+// 삭제할 노드까지의 경로를 키만으로 찾을 수 없으므로 같은 키는 노드 주소 순서로 정렬합니다.
+static inline int rbtree_np_less__(const node_t *a, const node_t *b) {
+  return a->key < b->key || (a->key == b->key && (uintptr_t)a < (uintptr_t)b);
+}
+
+static inline node_t **rbtree_np_child__(node_t *n, int dir) {
+  return dir ? &n->right : &n->left;
+}
+
+/**
+ * @brief 힙에 새로운 rbtree를 생성하고 0으로 초기화합니다.
+ * @return 생성된 rbtree의 포인터를 반환합니다.
+ */
+rbtree *new_rbtree(void) {
+  rbtree *p = (rbtree *)calloc(1, sizeof(rbtree));
+  if (p == NULL) {
+    return NULL;
+  }
+
+  p->nil = &rbtree_nil__;
+  p->root = p->nil;
+  return p;
+}
+
+/**
+ * @brief 서브트리의 노드를 모두 해제합니다.
+ * @param[in] t: 대상 rbtree
+ * @param[in] n: 해제할 서브트리의 루트
+ */
+static void delete_node__(rbtree *t, node_t *n) {
+  if (n == t->nil) {
+    return;
+  }
+
+  delete_node__(t, n->left);
+  delete_node__(t, n->right);
+  free(n);
+}
+
+/**
+ * @brief rbtree를 삭제합니다.
+ * @param[in] t: 삭제할 rbtree
+ */
+void delete_rbtree(rbtree *t) {
+  delete_node__(t, t->root);
+  free(t);
+}
+
+/**
+ * @brief rbtree에 연산 hook을 등록합니다.
+ * @param[in] t: 대상 rbtree
+ * @param[in] hook: 연산마다 호출할 함수, @b NULL 이면 hook을 해제합니다.
+ * @param[in] ctx: hook에 그대로 전달할 값
+ */
+void rbtree_set_hook(rbtree *t, rbtree_hook_t hook, void *ctx) {
+  t->hook = hook;
+  t->hook_ctx = ctx;
+}
+
+static inline void rbtree_notify__(const rbtree *t, rbtree_op_t op, key_t arg) {
+  if (t->hook != NULL) {
+    t->hook(t->hook_ctx, op, arg);
+  }
+}
+
+/**
+ * @brief 노드를 dir 방향으로 회전합니다. dir이 0이면 왼쪽, 1이면 오른쪽 회전입니다.
+ * @param[in] n: 회전할 노드
+ * @param[in] dir: 회전 방향
+ * @return 서브트리의 새 루트, 호출한 쪽이 n이 있던 자리에 연결해야 합니다.
+ */
+static node_t *rbtree_np_rotate__(node_t *n, int dir) {
+  node_t *y = *rbtree_np_child__(n, !dir);
+  *rbtree_np_child__(n, !dir) = *rbtree_np_child__(y, dir);
+  *rbtree_np_child__(y, dir) = n;
+  return y;
+}
+
+/**
+ * @brief 경로에서 깊이 depth인 자리에 노드를 연결합니다.
+ * @param[in] t: 대상 rbtree
+ * @param[in] path: 루트부터 지나온 노드
+ * @param[in] dirs: path[i]에서 내려간 방향
+ * @param[in] depth: 연결할 자리의 깊이, 0이면 루트입니다.
+ * @param[in] n: 연결할 노드
+ */
+static inline void rbtree_np_link__(rbtree *t, node_t **path, const int *dirs, int depth, node_t *n) {
+  if (depth == 0) {
+    t->root = n;
+  } else {
+    *rbtree_np_child__(path[depth - 1], dirs[depth - 1]) = n;
+  }
+}
+
+/**
+ * @brief 새로운 키를 rbtree에 삽입합니다.
+ * @param[in] t: 대상 rbtree
+ * @param[in] key: 삽입할 키
+ * @return 삽입한 노드의 포인터를 반환합니다.
+ */
+node_t *rbtree_insert(rbtree *t, const key_t key) {
+  rbtree_notify__(t, RBTREE_OP_INSERT, key);
+
+  node_t *z = (node_t *)malloc(sizeof(node_t));
+  if (z == NULL) {
+    return NULL;
+  }
+  z->color = RBTREE_RED;
+  z->key = key;
+  z->left = t->nil;
+  z->right = t->nil;
+
+  node_t *path[RBTREE_NP_MAX_DEPTH];
+  int dirs[RBTREE_NP_MAX_DEPTH];
+  int k = 0;
+  for (node_t *c = t->root; c != t->nil; ++k) {
+    path[k] = c;
+    dirs[k] = !rbtree_np_less__(z, c);
+    c = *rbtree_np_child__(c, dirs[k]);
+  }
+  rbtree_np_link__(t, path, dirs, k, z);
+  t->size++;
+
+  // z는 깊이 k에 있고, 부모가 빨간색이면 부모는 루트가 아니므로 조부모가 있습니다.
+  while (k >= 2 && path[k - 1]->color == RBTREE_RED) {
+    node_t *p = path[k - 1];
+    node_t *g = path[k - 2];
+    const int pd = dirs[k - 2];
+    node_t *uncle = *rbtree_np_child__(g, !pd);
+
+    if (uncle->color == RBTREE_RED) {
+      p->color = RBTREE_BLACK;
+      uncle->color = RBTREE_BLACK;
+      g->color = RBTREE_RED;
+      k -= 2;
+      continue;
+    }
+
+    if (dirs[k - 1] != pd) {
+      *rbtree_np_child__(g, pd) = rbtree_np_rotate__(p, pd);
+      p = *rbtree_np_child__(g, pd);
+    }
+
+    p->color = RBTREE_BLACK;
+    g->color = RBTREE_RED;
+    rbtree_np_link__(t, path, dirs, k - 2, rbtree_np_rotate__(g, !pd));
+    break;
+  }
+
+  t->root->color = RBTREE_BLACK;
+  return z;
+}
+
+/**
+ * @brief rbtree에 키가 같은 노드를 찾습니다.
+ * @param[in] t: 대상 rbtree
+ * @param[in] key: 키
+ * @return 찾았다면 노드의 포인터를 반환하고 찾지 못했다면 @b NULL 을 반환합니다.
+ */
+node_t *rbtree_find(const rbtree *t, const key_t key) {
+  rbtree_notify__(t, RBTREE_OP_FIND, key);
+
+  node_t *n = t->root;
+  while (n != t->nil) {
+    if (key == n->key) {
+      return n;
+    }
+    n = (key < n->key) ? n->left : n->right;
+  }
+
+  return NULL;
+}
+
+/**
+ * @brief 최솟값을 찾습니다.
+ * @param[in] t: 대상 rbtree
+ * @return 최솟값의 노드를 반환하고, 비어 있다면 @b NULL 을 반환합니다.
+ */
+node_t *rbtree_min(const rbtree *t) {
+  rbtree_notify__(t, RBTREE_OP_MIN, 0);
+
+  node_t *n = t->root;
+  if (n == t->nil) {
+    return NULL;
+  }
+
+  while (n->left != t->nil) {
+    n = n->left;
+  }
+  return n;
+}
+
+/**
+ * @brief 최댓값을 찾습니다.
+ * @param[in] t: 대상 rbtree
+ * @return 최댓값의 노드를 반환하고, 비어 있다면 @b NULL 을 반환합니다.
+ */
+node_t *rbtree_max(const rbtree *t) {
+  rbtree_notify__(t, RBTREE_OP_MAX, 0);
+
+  node_t *n = t->root;
+  if (n == t->nil) {
+    return NULL;
+  }
+
+  while (n->right != t->nil) {
+    n = n->right;
+  }
+  return n;
+}
+
+/**
+ * @brief 노드를 삭제합니다.
+ * @param[in] t: 대상 rbtree
+ * @param[in] p: 대상 노드
+ * @return 성공하면 0, rbtree에 없는 노드라면 -1을 반환합니다.
+ */
+int rbtree_erase(rbtree *t, node_t *p) {
+  rbtree_notify__(t, RBTREE_OP_ERASE, p->key);
+
+  node_t *path[RBTREE_NP_MAX_DEPTH];
+  int dirs[RBTREE_NP_MAX_DEPTH];
+  int k = 0;
+  for (node_t *c = t->root; c != p; ++k) {
+    if (c == t->nil) {
+      return -1;
+    }
+    path[k] = c;
+    dirs[k] = !rbtree_np_less__(p, c);
+    c = *rbtree_np_child__(c, dirs[k]);
+  }
+
+  // x는 빠진 노드의 자리를 채운 서브트리이고, 경로에서 깊이 k에 있습니다.
+  node_t *x;
+  color_t removed = p->color;
+  if (p->left == t->nil || p->right == t->nil) {
+    x = (p->left == t->nil) ? p->right : p->left;
+    rbtree_np_link__(t, path, dirs, k, x);
+  } else {
+    // 후계자 y를 떼어 내고 p의 자리에 둡니다. 경로의 p도 y로 바뀝니다.
+    const int pk = k;
+    path[k] = p;
+    dirs[k++] = 1;
+    node_t *y = p->right;
+    while (y->left != t->nil) {
+      path[k] = y;
+      dirs[k++] = 0;
+      y = y->left;
+    }
+
+    removed = y->color;
+    x = y->right;
+    *rbtree_np_child__(path[k - 1], dirs[k - 1]) = x;
+
+    y->left = p->left;
+    y->right = p->right;
+    y->color = p->color;
+    rbtree_np_link__(t, path, dirs, pk, y);
+    path[pk] = y;
+  }
+
+  if (removed == RBTREE_BLACK) {
+    while (k > 0 && x->color == RBTREE_BLACK) {
+      node_t *parent = path[k - 1];
+      const int d = dirs[k - 1];
+      node_t *brother = *rbtree_np_child__(parent, !d);
+
+      if (brother->color == RBTREE_RED) {
+        brother->color = RBTREE_BLACK;
+        parent->color = RBTREE_RED;
+        rbtree_np_link__(t, path, dirs, k - 1, rbtree_np_rotate__(parent, d));
+        // 회전으로 brother가 parent 위에 끼어들었습니다.
+        path[k - 1] = brother;
+        dirs[k - 1] = d;
+        path[k] = parent;
+        dirs[k++] = d;
+        brother = *rbtree_np_child__(parent, !d);
+      }
+
+      if (brother->left->color == RBTREE_BLACK && brother->right->color == RBTREE_BLACK) {
+        brother->color = RBTREE_RED;
+        x = parent;
+        --k;
+        continue;
+      }
+
+      if ((*rbtree_np_child__(brother, !d))->color == RBTREE_BLACK) {
+        (*rbtree_np_child__(brother, d))->color = RBTREE_BLACK;
+        brother->color = RBTREE_RED;
+        brother = rbtree_np_rotate__(brother, !d);
+        *rbtree_np_child__(parent, !d) = brother;
+      }
+
+      brother->color = parent->color;
+      parent->color = RBTREE_BLACK;
+      (*rbtree_np_child__(brother, !d))->color = RBTREE_BLACK;
+      rbtree_np_link__(t, path, dirs, k - 1, rbtree_np_rotate__(parent, d));
+      x = t->root;
+      break;
+    }
+
+    if (x != t->nil) {
+      x->color = RBTREE_BLACK;
+    }
+  }
+
+  t->size--;
+  free(p);
+  return 0;
+}
+
+/**
+ * @brief rbtree를 중위 순회 순서로 배열에 씁니다. 재귀 대신 경로 스택으로 순회합니다.
+ * @param[in] t: 대상 rbtree
+ * @param[out] arr: 키를 순서대로 저장할 배열
+ * @param[in] n: 배열의 길이
+ */
+int rbtree_to_array(const rbtree *t, key_t *arr, const size_t n) {
+  rbtree_notify__(t, RBTREE_OP_TO_ARRAY, (n > INT32_MAX) ? INT32_MAX : (key_t)n);
+
+  node_t *stack[RBTREE_NP_MAX_DEPTH];
+  int top = 0;
+  size_t idx = 0;
+  node_t *c = t->root;
+  while (idx < n && (c != t->nil || top > 0)) {
+    if (c != t->nil) {
+      stack[top++] = c;
+      c = c->left;
+      continue;
+    }
+
+    c = stack[--top];
+    arr[idx++] = c->key;
+    c = c->right;
+  }
+
+  return 0;
+}
+
+/**
+ * @brief 서브트리를 전위 순회 순서로 스트림에 출력합니다.
+ * @param[out] stream: 대상 stream
+ * @param[in] t: 대상 rbtree
+ * @param[in] n: 현재 노드
+ * @param[in] indent: 현재 수준
+ */
+static void rbtree_print_preorder__(FILE *stream, const rbtree *t, const node_t *n, size_t indent) {
+  if (n == t->nil) {
+    return;
+  }
+
+  for (size_t i = 0; i < indent; ++i) {
+    fprintf(stream, " ");
+  }
+
+  fprintf(stream, "%d(%s)\n", n->key, (n->color == RBTREE_BLACK) ? "B" : "R");
+  rbtree_print_preorder__(stream, t, n->left, indent + 4);
+  rbtree_print_preorder__(stream, t, n->right, indent + 4);
+}
+
+/**
+ * @brief rbtree를 스트림에 출력합니다.
+ * @param[out] stream: 대상 stream
+ * @param[in] t: 대상 rbtree
+ */
+int rbtree_print(FILE *stream, const rbtree *t) {
+  if (stream == NULL) {
+    return -1;
+  }
+
+  rbtree_print_preorder__(stream, t, t->root, 0);
+  return 0;
+}
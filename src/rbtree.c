@@ -1,71 +1,158 @@
 #include "rbtree.h"
 
+#include <limits.h>
+#include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
+
+// 모든 rbtree가 함께 쓰는 sentinel. 어떤 연산도 이 노드에 쓰지 않으므로 여러 스레드가 각자의 rbtree를 써도 됩니다.
+// 한 rbtree를 여러 스레드가 함께 읽는 것은 find 캐시를 쓰지 않을 때만 안전합니다. (rbtree_set_find_cache() 참고)
+#ifdef RBTREE_INTERVAL
+static node_t rbtree_nil__ = {.color = RBTREE_BLACK, .hi = INT_MIN, .max = INT_MIN};
+#else
+static node_t rbtree_nil__ = {.color = RBTREE_BLACK};
+#endif
 
 /**
  * @brief 힙에 새로운 rbtree를 생성하고 0으로 초기화합니다.
  * @return 생성된 rbtree의 포인터를 반환합니다.
  */
 rbtree *new_rbtree(void) {
-  rbtree *p = (rbtree *)calloc(1, sizeof(rbtree));
-  if (p == NULL) {
-    return NULL;
-  }
+  return new_rbtree_small(0);
+}
 
-  p->nil = (node_t *)calloc(1, sizeof(node_t));
-  if (p->nil == NULL) {
-    if (p != NULL) {
-      free(p);
-    }
-    
+/**
+ * @brief 노드 pool을 함께 할당한 rbtree를 생성합니다.
+ *
+ * 처음 n개의 노드는 rbtree와 같은 할당 안에서 꺼내 쓰므로, 작은 rbtree는 할당 한 번으로 만들고 해제 한 번으로
+ * 지웁니다. pool이 다 차면 그 다음 노드부터 힙에 할당합니다.
+ * @param[in] n: rbtree와 함께 할당할 노드 수
+ * @return 생성된 rbtree의 포인터를 반환합니다.
+ */
+rbtree *new_rbtree_small(size_t n) {
+  rbtree *p = (rbtree *)malloc(sizeof(rbtree) + n * sizeof(node_t));
+  if (p == NULL) {
     return NULL;
   }
 
-  p->nil->color = RBTREE_BLACK;
+  // pool은 노드를 꺼낼 때 초기화하므로 헤더만 0으로 채웁니다.
+  memset(p, 0, sizeof(rbtree));
+  p->nil = &rbtree_nil__;
   p->root = p->nil;
-  
+  p->pool = p->pool_inline;
+  p->pool_cap = n;
+
   return p;
 }
 
 /**
- * @brief 힙에 새로운 node_t를 생성하고 0으로 초기화합니다.
+ * @brief 새로운 node_t를 생성하고 0으로 초기화합니다. pool에 남은 노드가 있다면 pool에서 꺼냅니다.
  * @param[in] t: 노드를 생성할 rbtree
  * @param[in] key: 해당 노드의 키 값
  * @return 생성된 node_t의 포인터를 반환합니다.
  */
 static node_t *new_node__(rbtree *t, key_t key) {
-  node_t *n = (node_t *)calloc(1, sizeof(node_t));
-  if (n == NULL) {
-    return NULL;
+  node_t *n;
+  if (t->pool_free != NULL) {
+    n = t->pool_free;
+    t->pool_free = n->parent;
+    memset(n, 0, sizeof(node_t));
+  } else if (t->pool_used < t->pool_cap) {
+    n = &t->pool[t->pool_used++];
+    memset(n, 0, sizeof(node_t));
+  } else {
+    n = (node_t *)calloc(1, sizeof(node_t));
+    if (n == NULL) {
+      return NULL;
+    }
   }
 
   n->color = RBTREE_RED;
   n->key = key;
+#ifdef RBTREE_INTERVAL
+  n->hi = key;
+  n->max = key;
+#endif
   n->left = t->nil;
   n->right = t->nil;
   
   return n;
 }
 
+static inline int rbtree_in_pool__(const rbtree *t, const node_t *n) {
+  return n >= t->pool && n < t->pool + t->pool_cap;
+}
+
 /**
- * @brief rbtree를 삭제합니다.
- * @param[in] t: 삭제할 rbtree
- * @param[in] n: 삭제할 서브트리
+ * @brief 노드를 해제합니다. pool의 노드는 pool로 돌려보냅니다.
+ * @param[in] t: 노드가 속한 rbtree
+ * @param[in] n: 해제할 노드
  */
-static void delete_node__(rbtree *t, node_t *n) {
-  if (t == NULL || n == NULL) {
+static void rbtree_free_node__(rbtree *t, node_t *n) {
+  if (rbtree_in_pool__(t, n)) {
+    n->parent = t->pool_free;
+    t->pool_free = n;
     return;
   }
 
-  if (n->left != t->nil) {
-    delete_node__(t, n->left);
+  free(n);
+}
+
+/**
+ * @brief rbtree를 조금씩 삭제합니다.
+ *
+ * 처음 호출하면 삽입 버퍼와 find 캐시를 바로 해제하고 hook을 떼어 냅니다. 이후 rbtree는 이 함수에만 넘길 수
+ * 있습니다. 노드는 루트에서 시작해 왼쪽 자식이 있으면 오른쪽으로 회전하고, 없으면 루트를 해제하고 오른쪽
+ * 자식으로 넘어가는 방식으로 해제합니다. 트리를 오른쪽으로 늘어선 목록으로 펴 가며 지우므로 스택이 필요
+ * 없고, 호출 사이의 상태는 루트 하나뿐입니다.
+ * @param[in] t: 삭제할 rbtree
+ * @param[in] budget: 이번 호출에서 할 회전과 해제의 최대 횟수
+ * @return 남은 노드가 있으면 1, 다 지워서 t까지 해제했다면 0을 반환합니다.
+ */
+int rbtree_delete_incremental(rbtree *t, size_t budget) {
+  for (size_t i = 0; i < t->buf_len; ++i) {
+    if (!rbtree_in_pool__(t, t->buf[i])) {
+      free(t->buf[i]);
+    }
   }
+  free(t->buf);
+  free(t->buf_keys);
+  free(t->cache);
+  t->buf = NULL;
+  t->buf_keys = NULL;
+  t->buf_len = 0;
+  t->buf_cap = 0;
+  t->cache = NULL;
+  t->hook = NULL;
 
-  if (n->right != t->nil) {
-    delete_node__(t, n->right);
+  // pool의 노드는 마지막에 헤더와 함께 해제됩니다.
+  node_t *n = t->root;
+  for (; n != t->nil && budget > 0; --budget) {
+    if (n->left != t->nil) {
+      node_t *l = n->left;
+      n->left = l->right;
+      l->right = n;
+      n = l;
+      continue;
+    }
+
+    node_t *next = n->right;
+    if (!rbtree_in_pool__(t, n)) {
+      free(n);
+    }
+    n = next;
   }
 
-  free(n);
+  t->root = n;
+  if (n != t->nil) {
+    return 1;
+  }
+
+  if (t->pool != t->pool_inline) {
+    free(t->pool);
+  }
+  free(t);
+  return 0;
 }
 
 /**
@@ -73,20 +160,134 @@ static void delete_node__(rbtree *t, node_t *n) {
  * @param[in] t: 삭제할 rbtree
  */
 void delete_rbtree(rbtree *t) {
-  node_t *root = t->root;
-  if (root != NULL) {
-    delete_node__(t, root);
+  while (rbtree_delete_incremental(t, SIZE_MAX)) {
   }
-  
-  if (t->nil != root) {
-    free(t->nil);
-    root = NULL;
-    t->nil = NULL;
+}
+
+/**
+ * @brief 노드를 복사해 pool에서 꺼낸 자리에 둡니다. 자식은 아직 복사하지 않았으므로 nil로 둡니다.
+ * @param[in] t: 복사본 rbtree
+ * @param[in] src: 원본 노드
+ * @param[in] parent: 복사본에서의 부모
+ * @return 복사된 노드를 반환합니다.
+ */
+static inline node_t *rbtree_clone_node__(rbtree *t, const node_t *src, node_t *parent) {
+  node_t *n = &t->pool[t->pool_used++];
+  *n = *src;
+  n->parent = parent;
+  n->left = t->nil;
+  n->right = t->nil;
+  return n;
+}
+
+/**
+ * @brief rbtree를 모양과 색 그대로 복제합니다.
+ *
+ * 모든 노드를 복사본 헤더와 함께 할당한 pool에 전위 순회 순서로 복사합니다. 원본과 복사본을 부모 포인터로
+ * 함께 따라 내려가므로 재귀나 스택 없이 선형 시간에 끝나며, 균형을 다시 맞추지 않습니다.
+ * 삽입 버퍼에 있는 노드와 tombstone도 복사합니다. hook은 복사하지 않고, find 캐시는 크기만 같은 빈 캐시로 둡니다.
+ * 노드 크기가 다른 바이트 키 rbtree는 복제할 수 없습니다.
+ * @param[in] src: 원본 rbtree
+ * @return 복사본 rbtree의 포인터를 반환하고, 바이트 키 rbtree이거나 할당에 실패하면 @b NULL 을 반환합니다.
+ */
+rbtree *rbtree_clone(const rbtree *src) {
+  if (src->bytes) {
+    return NULL;
+  }
+
+  rbtree *t = new_rbtree_small(src->size + src->buf_len);
+  if (t == NULL) {
+    return NULL;
+  }
+
+  if (rbtree_set_insert_buffer(t, src->buf_cap) != 0 ||
+      rbtree_set_find_cache(t, (src->cache != NULL) ? (size_t)1 << (32 - src->cache->shift) : 0) != 0) {
+    delete_rbtree(t);
+    return NULL;
+  }
+
+  t->size = src->size;
+  t->dead = src->dead;
+  t->lazy_ratio = src->lazy_ratio;
+
+  if (src->root != src->nil) {
+    const node_t *s = src->root;
+    node_t *d = rbtree_clone_node__(t, s, t->nil);
+    t->root = d;
+
+    // 복사본에서 아직 nil인 자식이 원본에서 nil이 아니라면 그쪽으로 내려가고, 아니면 함께 올라갑니다.
+    while (s != src->nil) {
+      if (s->left != src->nil && d->left == t->nil) {
+        d->left = rbtree_clone_node__(t, s->left, d);
+        s = s->left;
+        d = d->left;
+      } else if (s->right != src->nil && d->right == t->nil) {
+        d->right = rbtree_clone_node__(t, s->right, d);
+        s = s->right;
+        d = d->right;
+      } else {
+        s = s->parent;
+        d = d->parent;
+      }
+    }
+  }
+
+  for (size_t i = 0; i < src->buf_len; ++i) {
+    t->buf[i] = rbtree_clone_node__(t, src->buf[i], NULL);
+    t->buf_keys[i] = src->buf_keys[i];
+  }
+  t->buf_len = src->buf_len;
+
+  return t;
+}
+
+/**
+ * @brief rbtree에 연산 hook을 등록합니다.
+ * @param[in] t: 대상 rbtree
+ * @param[in] hook: 연산마다 호출할 함수, @b NULL 이면 hook을 해제합니다.
+ * @param[in] ctx: hook에 그대로 전달할 값
+ */
+void rbtree_set_hook(rbtree *t, rbtree_hook_t hook, void *ctx) {
+  t->hook = hook;
+  t->hook_ctx = ctx;
+}
+
+/**
+ * @brief 등록된 hook이 있다면 연산을 알립니다.
+ * @param[in] t: 대상 rbtree
+ * @param[in] op: 연산 종류
+ * @param[in] arg: 연산의 인자
+ */
+static inline void rbtree_notify__(const rbtree *t, rbtree_op_t op, key_t arg) {
+  if (t->hook != NULL) {
+    t->hook(t->hook_ctx, op, arg);
   }
-  
-  free(t);
 }
 
+#ifdef RBTREE_INTERVAL
+/**
+ * @brief 자식들의 값으로 노드의 구간 끝점 최댓값을 다시 계산합니다.
+ * @param[in] n: 대상 노드, nil이 아니어야 합니다.
+ */
+static inline void rbtree_update_max__(node_t *n) {
+  key_t max = n->hi;
+  if (n->left->max > max) {
+    max = n->left->max;
+  }
+
+  if (n->right->max > max) {
+    max = n->right->max;
+  }
+
+  n->max = max;
+}
+#else
+// 구간 모드가 아니면 노드에 끝점이 없으므로 회전과 재구성에서 할 일이 없습니다.
+static inline void rbtree_update_max__(node_t *n) {
+  (void)n;
+}
+#endif
+
 /**
  * @brief 노드를 왼쪽으로 회전합니다.
  * @param[in] t: 회전할 rbtree
@@ -111,6 +312,9 @@ static void rbtree_left_rotate__(rbtree *t, node_t *n) {
 
   y->left = n;
   n->parent = y;
+
+  rbtree_update_max__(n);
+  rbtree_update_max__(y);
 }
 
 /**
@@ -137,6 +341,9 @@ static void rbtree_right_rotate__(rbtree *t, node_t *n) {
 
   y->right = n;
   n->parent = y;
+
+  rbtree_update_max__(n);
+  rbtree_update_max__(y);
 }
 
 /**
@@ -188,223 +395,782 @@ static void rbtree_insert_fixup__(rbtree *t, node_t *n) {
 }
 
 /**
- * @brief 새로운 키를 rbtree에 삽입합니다.
+ * @brief 탐색으로 찾은 자리에 노드를 연결하고 균형을 맞춥니다.
  * @param[in] t: 대상 rbtree
- * @param[in] key: 키
- * @return 삽입한 노드의 포인터를 반환합니다.
+ * @param[in] parent: 새 노드의 부모, 빈 rbtree라면 nil
+ * @param[in] node: 삽입할 노드
+ * @param[in] to_left: 0이 아니면 parent의 왼쪽 자식으로 연결합니다.
  */
-node_t *rbtree_insert(rbtree *t, const key_t key) {
-  node_t *parent = t->nil;
-  node_t *cursor = t->root;
-  while (cursor != t->nil) {
-    parent = cursor;
-    if (key < cursor->key) {
-      cursor = cursor->left;
-      continue;
-    }
-    cursor = cursor->right;
-  }
-
-  node_t *node = new_node__(t, key);
+static void rbtree_link_node__(rbtree *t, node_t *parent, node_t *node, int to_left) {
   node->parent = parent;
   if (parent == t->nil) {
     t->root = node;
-  } else if (node->key < parent->key) {
+  } else if (to_left) {
     parent->left = node;
   } else {
     parent->right = node;
   }
 
   rbtree_insert_fixup__(t, node);
-  return t->root;
+  t->size++;
 }
 
 /**
- * @brief rbtree에 키가 같은 노드를 찾습니다.
+ * @brief 만들어진 노드를 rbtree에 연결하고 균형을 맞춥니다.
  * @param[in] t: 대상 rbtree
- * @param[in] key: 키
- * @return 찾았다면 노드의 포인터를 반환하고 찾지 못했다면 @b NULL 을 반환합니다.
+ * @param[in] node: 삽입할 노드
  */
-node_t *rbtree_find(const rbtree *t, const key_t key) {
+static void rbtree_insert_node__(rbtree *t, node_t *node) {
+  const key_t key = node->key;
+  node_t *parent = t->nil;
   node_t *cursor = t->root;
   while (cursor != t->nil) {
-    if (cursor->key == key) {
-      return cursor;
+    parent = cursor;
+#ifdef RBTREE_INTERVAL
+    if (node->max > cursor->max) {
+      cursor->max = node->max;
     }
+#endif
 
-    if (cursor->key > key) {
+    if (key < cursor->key) {
       cursor = cursor->left;
       continue;
     }
+    cursor = cursor->right;
+  }
 
-    if (cursor->key < key) {
-      cursor = cursor->right;
-      continue;
+  rbtree_link_node__(t, parent, node, parent != t->nil && key < parent->key);
+}
+
+/**
+ * @brief find 캐시를 설정합니다.
+ *
+ * find 캐시는 키마다 칸 하나를 정해 최근에 찾은 노드를 기억합니다. 같은 키를 반복해서 찾으면
+ * rbtree를 내려가지 않고 바로 반환합니다. 삭제된 노드와 같은 키가 새로 삽입된 칸은 비웁니다.
+ * rbtree_find()가 칸과 적중 횟수를 고치므로, 캐시를 쓰는 rbtree는 rbtree_find()도 쓰기 연산처럼
+ * 한 스레드에서만 호출해야 합니다.
+ * @param[in] t: 대상 rbtree
+ * @param[in] slots: 칸의 수, 2의 거듭제곱으로 올림합니다. 0이면 캐시를 쓰지 않습니다.
+ * @return 성공하면 0, 메모리가 부족하면 -1을 반환합니다.
+ */
+int rbtree_set_find_cache(rbtree *t, size_t slots) {
+  free(t->cache);
+  t->cache = NULL;
+  if (slots == 0) {
+    return 0;
+  }
+
+  unsigned bits = 0;
+  while (((size_t)1 << bits) < slots && bits < 31) {
+    ++bits;
+  }
+
+  rbtree_cache_t *c = (rbtree_cache_t *)calloc(1, sizeof(rbtree_cache_t) + ((size_t)1 << bits) * sizeof(node_t *));
+  if (c == NULL) {
+    return -1;
+  }
+
+  c->shift = 32 - bits;
+  t->cache = c;
+  return 0;
+}
+
+/**
+ * @brief find 캐시에서 키가 들어갈 칸을 구합니다. (Fibonacci hashing)
+ * @param[in] c: find 캐시
+ * @param[in] key: 키
+ */
+static inline node_t **rbtree_cache_slot__(rbtree_cache_t *c, const key_t key) {
+  uint32_t h = (uint32_t)key * 2654435769u;
+  return &c->slots[(c->shift < 32) ? (h >> c->shift) : 0];
+}
+
+/**
+ * @brief 노드를 가리키는 find 캐시의 칸을 비웁니다.
+ * @param[in] t: 대상 rbtree
+ * @param[in] p: 대상 노드
+ */
+static inline void rbtree_cache_forget__(const rbtree *t, const node_t *p) {
+  if (t->cache != NULL) {
+    node_t **slot = rbtree_cache_slot__(t->cache, p->key);
+    if (*slot == p) {
+      *slot = NULL;
     }
   }
+}
 
-  return NULL;
+static int rbtree_buffer_comp__(const void *p1, const void *p2) {
+  const key_t e1 = (*(node_t *const *)p1)->key;
+  const key_t e2 = (*(node_t *const *)p2)->key;
+  return (e1 > e2) - (e1 < e2);
 }
 
 /**
- * @brief 서브트리의 최솟값을 찾습니다.
+ * @brief 삽입 버퍼의 노드를 정렬된 순서로 rbtree에 모두 삽입합니다.
  * @param[in] t: 대상 rbtree
- * @param[in] subroot: 대상 서브트리의 루트 
- * @return subroot가 NULL이면 NULL을 반환하고, 그렇지 않으면 서브트리의 최솟값을 반환합니다.
  */
-static node_t *rbtree_sub_min__(const rbtree *t, node_t *subroot) {
-  if (subroot == NULL) {
-    return NULL;
+void rbtree_flush(rbtree *t) {
+  if (t->buf_len == 0) {
+    return;
   }
 
-  node_t *cursor = subroot;
-  while (cursor->left != t->nil) {
-    cursor = cursor->left;
+  // 정렬된 순서로 삽입하면 연속된 탐색 경로가 겹쳐 캐시에 남아 있습니다.
+  qsort(t->buf, t->buf_len, sizeof(node_t *), rbtree_buffer_comp__);
+  for (size_t i = 0; i < t->buf_len; ++i) {
+    rbtree_insert_node__(t, t->buf[i]);
   }
 
-  return cursor;
+  t->buf_len = 0;
 }
 
 /**
- * @brief 서브트리의 최댓값을 찾습니다.
+ * @brief 삽입 버퍼의 크기를 설정합니다.
+ *
+ * 삽입 버퍼를 쓰면 rbtree_insert()는 노드를 버퍼에 덧붙이기만 하고,
+ * 버퍼가 가득 차면 rbtree_flush()로 한꺼번에 rbtree에 삽입합니다.
+ * find, min, max, to_array는 버퍼도 함께 살펴봅니다. 구간 질의와 바이트 키는 버퍼를 거치지 않습니다.
  * @param[in] t: 대상 rbtree
- * @param[in] subroot: 대상 서브트리의 루트 
- * @return subroot가 NULL이면 NULL을 반환하고, 그렇지 않으면 서브트리의 최댓값을 반환합니다.
+ * @param[in] cap: 버퍼에 담을 노드의 수, 0이면 버퍼를 비우고 쓰지 않습니다.
+ * @return 성공하면 0, 메모리가 부족하면 -1을 반환합니다.
  */
-static node_t *rbtree_sub_max__(const rbtree *t, node_t *subroot) {
-  if (subroot == NULL) {
-    return NULL;
+int rbtree_set_insert_buffer(rbtree *t, size_t cap) {
+  rbtree_flush(t);
+  free(t->buf);
+  free(t->buf_keys);
+  t->buf = NULL;
+  t->buf_keys = NULL;
+  t->buf_cap = 0;
+
+  if (cap == 0) {
+    return 0;
   }
 
-  node_t *cursor = subroot;
-  while (cursor->right != t->nil) {
-    cursor = cursor->right;
+  t->buf = (node_t **)malloc(cap * sizeof(node_t *));
+  t->buf_keys = (key_t *)malloc(cap * sizeof(key_t));
+  if (t->buf == NULL || t->buf_keys == NULL) {
+    free(t->buf);
+    free(t->buf_keys);
+    t->buf = NULL;
+    t->buf_keys = NULL;
+    return -1;
   }
 
-  return cursor;
+  t->buf_cap = cap;
+  return 0;
 }
 
 /**
- * @brief 최솟값을 찾습니다.
+ * @brief 삽입 버퍼에서 키가 같은 노드를 찾습니다.
  * @param[in] t: 대상 rbtree
- * @return 최솟값을 가진 노드의 포인터를 반환합니다.
+ * @param[in] key: 키
+ * @return 찾았다면 노드의 포인터를 반환하고 찾지 못했다면 @b NULL 을 반환합니다.
  */
-node_t *rbtree_min(const rbtree *t) {
-  node_t *cursor = t->root;
-  while (cursor->left != t->nil) {
-    cursor = cursor->left;
+static node_t *rbtree_buffer_find__(const rbtree *t, const key_t key) {
+  for (size_t i = 0; i < t->buf_len; ++i) {
+    if (t->buf_keys[i] == key) {
+      return t->buf[i];
+    }
   }
 
-  return cursor;
+  return NULL;
 }
 
 /**
- * @brief 최댓값을 찾습니다.
+ * @brief 삽입 버퍼에서 키가 가장 작거나 큰 노드를 찾습니다.
  * @param[in] t: 대상 rbtree
- * @return 최댓값을 가진 노드의 포인터를 반환합니다.
+ * @param[in] want_max: 0이 아니면 가장 큰 노드를 찾습니다.
+ * @return 버퍼가 비어 있다면 @b NULL 을 반환합니다.
  */
-node_t *rbtree_max(const rbtree *t) {
-  node_t *cursor = t->root;
-  while (cursor->right != t->nil) {
-    cursor = cursor->right;
+static node_t *rbtree_buffer_extreme__(const rbtree *t, int want_max) {
+  if (t->buf_len == 0) {
+    return NULL;
   }
-  
-  return cursor;
+
+  size_t best = 0;
+  for (size_t i = 1; i < t->buf_len; ++i) {
+    if (want_max ? t->buf_keys[i] > t->buf_keys[best] : t->buf_keys[i] < t->buf_keys[best]) {
+      best = i;
+    }
+  }
+
+  return t->buf[best];
 }
 
 /**
- * @brief dest에 src를 옮깁니다.
+ * @brief 삽입 버퍼에서 노드를 빼고 해제합니다.
  * @param[in] t: 대상 rbtree
- * @param[in] dest: 옮겨질 노드
- * @param[in] src: 옮길 서브트리의 루트 노드
+ * @param[in] p: 버퍼에 있는 노드
+ * @return 성공하면 0, 버퍼에 없는 노드라면 -1을 반환합니다.
  */
-static void rbtree_transplant__(rbtree *t, node_t *dest, node_t *src) {
-  if (dest->parent == t->nil) {
-    t->root = src;
-  } else if (dest == dest->parent->left) {
-    dest->parent->left = src;
-  } else {
-    dest->parent->right = src;
+static int rbtree_buffer_erase__(rbtree *t, node_t *p) {
+  for (size_t i = 0; i < t->buf_len; ++i) {
+    if (t->buf[i] == p) {
+      --t->buf_len;
+      t->buf[i] = t->buf[t->buf_len];
+      t->buf_keys[i] = t->buf_keys[t->buf_len];
+      rbtree_free_node__(t, p);
+      return 0;
+    }
   }
-  src->parent = dest->parent;
+
+  return -1;
 }
 
 /**
- * @brief 노드 삭제로 인해 망가진 rbtree의 성질을 복구합니다.
+ * @brief 키 key의 삽입을 hook에 알리고, 같은 키의 find 캐시 칸을 비웁니다.
  * @param[in] t: 대상 rbtree
- * @param[in] n: 대상 노드
+ * @param[in] key: 삽입할 키
  */
-static void rbtree_erase_fixup__(rbtree *t, node_t *n) {
-  node_t *brother;
-  while (n != t->root && n->color == RBTREE_BLACK) {
-    if (n == n->parent->left) {
-      brother = n->parent->right;
-      if (brother->color == RBTREE_RED) {
-        brother->color = RBTREE_BLACK;
-        n->parent->color = RBTREE_RED;
-        rbtree_left_rotate__(t, n->parent);
-        brother = n->parent->right;
-      }
-
-      if (brother->left->color == RBTREE_BLACK && brother->right->color == RBTREE_BLACK) {
-        brother->color = RBTREE_RED;
-        n = n->parent;
-      } else {
-        if (brother->right->color == RBTREE_BLACK) {
-          brother->left->color = RBTREE_BLACK;
-          brother->color = RBTREE_RED;
-          rbtree_right_rotate__(t, brother);
-          brother = n->parent->right;
-        }
-        brother->color = n->parent->color;
-        n->parent->color = RBTREE_BLACK;
-        brother->right->color = RBTREE_BLACK;
-        rbtree_left_rotate__(t, n->parent);
-        n = t->root;
-      }
-    } else {
-      brother = n->parent->left;
-      if (brother->color == RBTREE_RED) {
-        brother->color = RBTREE_BLACK;
-        n->parent->color = RBTREE_RED;
-        rbtree_right_rotate__(t, n->parent);
-        brother = n->parent->left;
-      }
+static void rbtree_begin_insert__(rbtree *t, const key_t key) {
+  rbtree_notify__(t, RBTREE_OP_INSERT, key);
 
-      if (brother->right->color == RBTREE_BLACK && brother->left->color == RBTREE_BLACK) {
-        brother->color = RBTREE_RED;
-        n = n->parent;
-      } else {
-        if (brother->left->color == RBTREE_BLACK) {
-          brother->right->color = RBTREE_BLACK;
-          brother->color = RBTREE_RED;
-          rbtree_left_rotate__(t, brother);
-          brother = n->parent->left;
-        }
-        brother->color = n->parent->color;
-        n->parent->color = RBTREE_BLACK;
-        brother->left->color = RBTREE_BLACK;
-        rbtree_right_rotate__(t, n->parent);
-        n = t->root;
-      }
-    }
+  // 같은 키의 캐시 칸을 비워 다음 find가 캐시 없이 찾았을 때와 같은 노드를 돌려주게 합니다.
+  if (t->cache != NULL) {
+    *rbtree_cache_slot__(t->cache, key) = NULL;
   }
-
-  n->color = RBTREE_BLACK;
 }
 
 /**
- * @brief 노드를 삭제합니다.
+ * @brief 새로운 키를 rbtree에 삽입합니다.
  * @param[in] t: 대상 rbtree
- * @param[in] p: 대상 노드
+ * @param[in] key: 키
+ * @return 삽입한 노드의 포인터를 반환합니다.
  */
-int rbtree_erase(rbtree *t, node_t *p) {
-  node_t *x;
-  node_t *y = p;
-  color_t y_color = y->color;
+node_t *rbtree_insert(rbtree *t, const key_t key) {
+  rbtree_begin_insert__(t, key);
 
-  if (p->left == t->nil) {
-    x = p->right;
+  if (t->buf_cap > 0 && t->buf_len == t->buf_cap) {
+    rbtree_flush(t);
+  }
+
+  node_t *node = new_node__(t, key);
+  if (node == NULL) {
+    return NULL;
+  }
+
+  if (t->buf_cap > 0) {
+    // 버퍼의 노드는 parent가 NULL인 것으로 rbtree의 노드와 구분합니다.
+    node->parent = NULL;
+    t->buf[t->buf_len] = node;
+    t->buf_keys[t->buf_len++] = key;
+    return node;
+  }
+
+  rbtree_insert_node__(t, node);
+  return node;
+}
+
+/**
+ * @brief 서브트리에서 키가 같고 tombstone이 아닌 노드를 찾습니다.
+ * @param[in] t: 대상 rbtree
+ * @param[in] n: 대상 서브트리의 루트
+ * @param[in] key: 키
+ * @return 찾았다면 노드의 포인터를 반환하고 찾지 못했다면 @b NULL 을 반환합니다.
+ */
+static node_t *rbtree_find_live__(const rbtree *t, node_t *n, const key_t key) {
+  while (n != t->nil) {
+    if (n->key == key) {
+      if (!n->dead) {
+        return n;
+      }
+
+      // 같은 키는 회전에 의해 양쪽 서브트리 모두에 있을 수 있습니다.
+      node_t *found = rbtree_find_live__(t, n->left, key);
+      if (found != NULL) {
+        return found;
+      }
+      n = n->right;
+      continue;
+    }
+
+    n = (key < n->key) ? n->left : n->right;
+  }
+
+  return NULL;
+}
+
+/**
+ * @brief rbtree와 삽입 버퍼에서 키가 같은 노드를 찾습니다.
+ * @param[in] t: 대상 rbtree
+ * @param[in] key: 키
+ * @return 찾았다면 노드의 포인터를 반환하고 찾지 못했다면 @b NULL 을 반환합니다.
+ */
+static node_t *rbtree_find_node__(const rbtree *t, const key_t key) {
+  node_t *cursor = t->root;
+  while (cursor != t->nil) {
+    if (cursor->key == key) {
+      if (!cursor->dead) {
+        return cursor;
+      }
+
+      node_t *found = rbtree_find_live__(t, cursor, key);
+      return (found != NULL) ? found : rbtree_buffer_find__(t, key);
+    }
+
+    if (cursor->key > key) {
+      cursor = cursor->left;
+      continue;
+    }
+
+    if (cursor->key < key) {
+      cursor = cursor->right;
+      continue;
+    }
+  }
+
+  return rbtree_buffer_find__(t, key);
+}
+
+/**
+ * @brief rbtree에 키가 같은 노드를 찾습니다.
+ *
+ * find 캐시가 있으면 t가 const여도 캐시를 고칩니다. 이때는 여러 스레드가 동시에 호출하면 안 됩니다.
+ * @param[in] t: 대상 rbtree
+ * @param[in] key: 키
+ * @return 찾았다면 노드의 포인터를 반환하고 찾지 못했다면 @b NULL 을 반환합니다.
+ */
+node_t *rbtree_find(const rbtree *t, const key_t key) {
+  rbtree_notify__(t, RBTREE_OP_FIND, key);
+
+  rbtree_cache_t *c = t->cache;
+  if (c == NULL) {
+    return rbtree_find_node__(t, key);
+  }
+
+  node_t **slot = rbtree_cache_slot__(c, key);
+  if (*slot != NULL && (*slot)->key == key) {
+    c->hits++;
+    return *slot;
+  }
+
+  c->misses++;
+  node_t *found = rbtree_find_node__(t, key);
+  if (found != NULL) {
+    *slot = found;
+  }
+
+  return found;
+}
+
+/**
+ * @brief 서브트리의 최솟값을 찾습니다.
+ * @param[in] t: 대상 rbtree
+ * @param[in] subroot: 대상 서브트리의 루트 
+ * @return subroot가 NULL이면 NULL을 반환하고, 그렇지 않으면 서브트리의 최솟값을 반환합니다.
+ */
+static node_t *rbtree_sub_min__(const rbtree *t, node_t *subroot) {
+  if (subroot == NULL) {
+    return NULL;
+  }
+
+  node_t *cursor = subroot;
+  while (cursor->left != t->nil) {
+    cursor = cursor->left;
+  }
+
+  return cursor;
+}
+
+/**
+ * @brief 서브트리의 최댓값을 찾습니다.
+ * @param[in] t: 대상 rbtree
+ * @param[in] subroot: 대상 서브트리의 루트 
+ * @return subroot가 NULL이면 NULL을 반환하고, 그렇지 않으면 서브트리의 최댓값을 반환합니다.
+ */
+static node_t *rbtree_sub_max__(const rbtree *t, node_t *subroot) {
+  if (subroot == NULL) {
+    return NULL;
+  }
+
+  node_t *cursor = subroot;
+  while (cursor->right != t->nil) {
+    cursor = cursor->right;
+  }
+
+  return cursor;
+}
+
+/**
+ * @brief 중위 순회 순서에서 다음 노드를 찾습니다.
+ * @param[in] t: 대상 rbtree
+ * @param[in] n: 현재 노드
+ * @return 다음 노드, 없으면 nil을 반환합니다.
+ */
+static node_t *rbtree_next__(const rbtree *t, node_t *n) {
+  if (n->right != t->nil) {
+    return rbtree_sub_min__(t, n->right);
+  }
+
+  node_t *parent = n->parent;
+  while (parent != t->nil && n == parent->right) {
+    n = parent;
+    parent = parent->parent;
+  }
+
+  return parent;
+}
+
+/**
+ * @brief 중위 순회 순서에서 이전 노드를 찾습니다.
+ * @param[in] t: 대상 rbtree
+ * @param[in] n: 현재 노드
+ * @return 이전 노드, 없으면 nil을 반환합니다.
+ */
+static node_t *rbtree_prev__(const rbtree *t, node_t *n) {
+  if (n->left != t->nil) {
+    return rbtree_sub_max__(t, n->left);
+  }
+
+  node_t *parent = n->parent;
+  while (parent != t->nil && n == parent->left) {
+    n = parent;
+    parent = parent->parent;
+  }
+
+  return parent;
+}
+
+/**
+ * @brief 최솟값을 찾습니다.
+ * @param[in] t: 대상 rbtree
+ * @return 최솟값을 가진 노드의 포인터를 반환하고, 비어 있다면 @b NULL 을 반환합니다.
+ */
+node_t *rbtree_min(const rbtree *t) {
+  rbtree_notify__(t, RBTREE_OP_MIN, 0);
+
+  node_t *buffered = rbtree_buffer_extreme__(t, 0);
+  if (t->root == t->nil) {
+    return buffered;
+  }
+
+  node_t *cursor = rbtree_sub_min__(t, t->root);
+  while (cursor != t->nil && cursor->dead) {
+    cursor = rbtree_next__(t, cursor);
+  }
+
+  if (cursor == t->nil || (buffered != NULL && buffered->key < cursor->key)) {
+    return buffered;
+  }
+
+  return cursor;
+}
+
+/**
+ * @brief 최댓값을 찾습니다.
+ * @param[in] t: 대상 rbtree
+ * @return 최댓값을 가진 노드의 포인터를 반환하고, 비어 있다면 @b NULL 을 반환합니다.
+ */
+node_t *rbtree_max(const rbtree *t) {
+  rbtree_notify__(t, RBTREE_OP_MAX, 0);
+
+  node_t *buffered = rbtree_buffer_extreme__(t, 1);
+  if (t->root == t->nil) {
+    return buffered;
+  }
+
+  node_t *cursor = rbtree_sub_max__(t, t->root);
+  while (cursor != t->nil && cursor->dead) {
+    cursor = rbtree_prev__(t, cursor);
+  }
+
+  if (cursor == t->nil || (buffered != NULL && buffered->key > cursor->key)) {
+    return buffered;
+  }
+
+  return cursor;
+}
+
+/**
+ * @brief dest에 src를 옮깁니다.
+ * @param[in] t: 대상 rbtree
+ * @param[in] dest: 옮겨질 노드
+ * @param[in] src: 옮길 서브트리의 루트 노드
+ */
+static void rbtree_transplant__(rbtree *t, node_t *dest, node_t *src) {
+  if (dest->parent == t->nil) {
+    t->root = src;
+  } else if (dest == dest->parent->left) {
+    dest->parent->left = src;
+  } else {
+    dest->parent->right = src;
+  }
+
+  if (src != t->nil) {
+    src->parent = dest->parent;
+  }
+}
+
+/**
+ * @brief 노드 삭제로 인해 망가진 rbtree의 성질을 복구합니다.
+ * @param[in] t: 대상 rbtree
+ * @param[in] n: 대상 노드
+ * @param[in] parent: n의 부모, n이 nil일 수 있으므로 따로 받습니다.
+ */
+static void rbtree_erase_fixup__(rbtree *t, node_t *n, node_t *parent) {
+  node_t *brother;
+  while (n != t->root && n->color == RBTREE_BLACK) {
+    if (n == parent->left) {
+      brother = parent->right;
+      if (brother->color == RBTREE_RED) {
+        brother->color = RBTREE_BLACK;
+        parent->color = RBTREE_RED;
+        rbtree_left_rotate__(t, parent);
+        brother = parent->right;
+      }
+
+      if (brother->left->color == RBTREE_BLACK && brother->right->color == RBTREE_BLACK) {
+        brother->color = RBTREE_RED;
+        n = parent;
+        parent = n->parent;
+      } else {
+        if (brother->right->color == RBTREE_BLACK) {
+          brother->left->color = RBTREE_BLACK;
+          brother->color = RBTREE_RED;
+          rbtree_right_rotate__(t, brother);
+          brother = parent->right;
+        }
+        brother->color = parent->color;
+        parent->color = RBTREE_BLACK;
+        brother->right->color = RBTREE_BLACK;
+        rbtree_left_rotate__(t, parent);
+        n = t->root;
+      }
+    } else {
+      brother = parent->left;
+      if (brother->color == RBTREE_RED) {
+        brother->color = RBTREE_BLACK;
+        parent->color = RBTREE_RED;
+        rbtree_right_rotate__(t, parent);
+        brother = parent->left;
+      }
+
+      if (brother->right->color == RBTREE_BLACK && brother->left->color == RBTREE_BLACK) {
+        brother->color = RBTREE_RED;
+        n = parent;
+        parent = n->parent;
+      } else {
+        if (brother->left->color == RBTREE_BLACK) {
+          brother->right->color = RBTREE_BLACK;
+          brother->color = RBTREE_RED;
+          rbtree_left_rotate__(t, brother);
+          brother = parent->left;
+        }
+        brother->color = parent->color;
+        parent->color = RBTREE_BLACK;
+        brother->left->color = RBTREE_BLACK;
+        rbtree_right_rotate__(t, parent);
+        n = t->root;
+      }
+    }
+  }
+
+  if (n != t->nil) {
+    n->color = RBTREE_BLACK;
+  }
+}
+
+/**
+ * @brief 정렬된 노드 배열로 균형 잡힌 서브트리를 만듭니다.
+ * @param[in] t: 대상 rbtree
+ * @param[in] nodes: 중위 순회 순서로 정렬된 노드 배열
+ * @param[in] lo: 서브트리에 들어갈 첫 인덱스
+ * @param[in] hi: 서브트리에 들어갈 마지막 인덱스 + 1
+ * @param[in] parent: 서브트리의 부모
+ * @param[in] depth: 서브트리 루트의 깊이
+ * @param[in] red_depth: 빨간색으로 칠할 깊이, 가득 차지 않은 마지막 수준입니다.
+ * @return 서브트리의 루트를 반환합니다.
+ */
+static node_t *rbtree_build__(rbtree *t, node_t **nodes, size_t lo, size_t hi, node_t *parent, size_t depth,
+                              size_t red_depth) {
+  if (lo >= hi) {
+    return t->nil;
+  }
+
+  size_t mid = lo + (hi - lo) / 2;
+  node_t *n = nodes[mid];
+  n->parent = parent;
+  n->color = (depth == red_depth) ? RBTREE_RED : RBTREE_BLACK;
+  n->left = rbtree_build__(t, nodes, lo, mid, n, depth + 1, red_depth);
+  n->right = rbtree_build__(t, nodes, mid + 1, hi, n, depth + 1, red_depth);
+  rbtree_update_max__(n);
+
+  return n;
+}
+
+/**
+ * @brief tombstone을 모두 해제하고 남은 노드로 rbtree를 한 번에 다시 만듭니다.
+ * @param[in] t: 대상 rbtree
+ * @return 성공하면 0, 할당에 실패하면 -1을 반환합니다. 실패하면 rbtree와 tombstone은 그대로입니다.
+ */
+static int rbtree_rebuild__(rbtree *t) {
+  if (t->dead == 0) {
+    return 0;
+  }
+
+  // 해제된 노드를 지나는 순회를 피하기 위해 먼저 모든 노드를 모읍니다.
+  node_t **nodes = (node_t **)malloc(t->size * sizeof(node_t *));
+  if (nodes == NULL) {
+    return -1;
+  }
+
+  size_t total = 0;
+  for (node_t *n = rbtree_sub_min__(t, t->root); n != t->nil; n = rbtree_next__(t, n)) {
+    nodes[total++] = n;
+  }
+
+  size_t live = 0;
+  for (size_t i = 0; i < total; ++i) {
+    if (nodes[i]->dead) {
+      rbtree_free_node__(t, nodes[i]);
+      continue;
+    }
+    nodes[live++] = nodes[i];
+  }
+
+  // live개의 노드가 들어가는 가장 깊은 수준이 가득 차지 않았다면 그 수준만 빨간색입니다.
+  size_t depth = 0;
+  while (((size_t)2 << depth) <= live) {
+    ++depth;
+  }
+  size_t red_depth = (live == ((size_t)2 << depth) - 1) ? SIZE_MAX : depth;
+
+  t->root = rbtree_build__(t, nodes, 0, live, t->nil, 0, red_depth);
+  t->size = live;
+  t->dead = 0;
+  free(nodes);
+  return 0;
+}
+
+/**
+ * @brief 지연 삭제 모드를 설정합니다.
+ *
+ * 지연 삭제 모드에서 rbtree_erase()는 노드를 tombstone으로 표시만 하고,
+ * tombstone의 비율이 ratio를 넘으면 rbtree를 선형 시간에 다시 만들며 tombstone을 해제합니다.
+ * @param[in] t: 대상 rbtree
+ * @param[in] ratio: 0 이상 1 미만의 비율, 0이면 지연 삭제 모드를 끄고 남은 tombstone을 해제합니다.
+ * @return 성공하면 0, ratio가 범위를 벗어나거나 tombstone을 해제하지 못하면 -1을 반환합니다.
+ *         tombstone을 해제하지 못했다면 지연 삭제 모드는 그대로 켜져 있습니다.
+ */
+int rbtree_set_lazy_erase(rbtree *t, double ratio) {
+  if (!(ratio >= 0 && ratio < 1)) {
+    return -1;
+  }
+
+  if (ratio == 0 && rbtree_rebuild__(t) != 0) {
+    return -1;
+  }
+
+  t->lazy_ratio = ratio;
+  return 0;
+}
+
+// 옮기기 전 노드의 left에 새 위치를 적어 두므로, 옛 노드를 가리키는 링크를 새 위치로 바꿉니다.
+static inline node_t *rbtree_forward__(const rbtree *t, node_t *old) {
+  return (old == t->nil) ? t->nil : old->left;
+}
+
+/**
+ * @brief 모든 노드를 중위 순회 순서대로 연속된 블록 하나로 옮깁니다.
+ *
+ * 삽입과 삭제가 오래 반복되면 노드가 힙 곳곳에 흩어져 순회할 때마다 캐시 미스가 납니다. 먼저 삽입 버퍼를
+ * 비우고 tombstone을 정리한 뒤, 노드를 새 블록에 복사하고 left/right/parent 링크를 새 위치로 바꿉니다.
+ * 트리의 모양과 색은 그대로이고, 새 블록은 노드 pool이 되므로 이후에도 삽입과 삭제를 그대로 할 수 있습니다.
+ * 옛 노드는 해제되므로 이전에 받은 노드 포인터는 모두 무효가 되고, find 캐시도 비웁니다.
+ * 노드 크기가 다른 바이트 키 rbtree는 옮길 수 없습니다.
+ * @param[in] t: 대상 rbtree
+ * @return 성공하면 0, 바이트 키 rbtree이거나 할당에 실패하면 -1을 반환합니다. 실패해도 rbtree의 내용은 그대로입니다.
+ */
+int rbtree_compact(rbtree *t) {
+  if (t->bytes) {
+    return -1;
+  }
+
+  rbtree_flush(t);
+  if (rbtree_rebuild__(t) != 0) {
+    return -1;
+  }
+
+  const size_t n = t->size;
+  node_t *block = (n > 0) ? (node_t *)malloc(n * sizeof(node_t)) : NULL;
+  node_t **old = (n > 0) ? (node_t **)malloc(n * sizeof(node_t *)) : NULL;
+  if (n > 0 && (block == NULL || old == NULL)) {
+    free(block);
+    free(old);
+    return -1;
+  }
+
+  size_t i = 0;
+  for (node_t *p = (n > 0) ? rbtree_sub_min__(t, t->root) : t->nil; p != t->nil; p = rbtree_next__(t, p)) {
+    old[i] = p;
+    block[i++] = *p;
+  }
+
+  for (i = 0; i < n; ++i) {
+    old[i]->left = &block[i];
+  }
+
+  for (i = 0; i < n; ++i) {
+    block[i].left = rbtree_forward__(t, block[i].left);
+    block[i].right = rbtree_forward__(t, block[i].right);
+    block[i].parent = rbtree_forward__(t, block[i].parent);
+  }
+  t->root = rbtree_forward__(t, t->root);
+
+  for (i = 0; i < n; ++i) {
+    if (!rbtree_in_pool__(t, old[i])) {
+      free(old[i]);
+    }
+  }
+  free(old);
+
+  if (t->pool != t->pool_inline) {
+    free(t->pool);
+  }
+  t->pool = block;
+  t->pool_cap = n;
+  t->pool_used = n;
+  t->pool_free = NULL;
+
+  if (t->cache != NULL) {
+    memset(t->cache->slots, 0, ((size_t)1 << (32 - t->cache->shift)) * sizeof(node_t *));
+  }
+  return 0;
+}
+
+/**
+ * @brief 노드를 삭제합니다.
+ * @param[in] t: 대상 rbtree
+ * @param[in] p: 대상 노드
+ */
+int rbtree_erase(rbtree *t, node_t *p) {
+  rbtree_notify__(t, RBTREE_OP_ERASE, p->key);
+  rbtree_cache_forget__(t, p);
+
+  if (p->parent == NULL) {
+    return rbtree_buffer_erase__(t, p);
+  }
+
+  if (t->lazy_ratio > 0) {
+    if (p->dead) {
+      return -1;
+    }
+
+    p->dead = 1;
+    t->dead++;
+    // 재구성에 실패해도 삭제 표시는 끝났으므로, tombstone은 다음 삭제에서 다시 정리합니다.
+    if ((double)t->dead > t->lazy_ratio * (double)t->size) {
+      rbtree_rebuild__(t);
+    }
+    return 0;
+  }
+
+  node_t *x;
+  node_t *x_parent = p->parent;  // x가 nil이어도 sentinel에 쓰지 않도록 x의 부모를 따로 둡니다.
+  node_t *y = p;
+  color_t y_color = y->color;
+
+  if (p->left == t->nil) {
+    x = p->right;
     rbtree_transplant__(t, p, p->right);
   } else if (p->right == t->nil) {
     x = p->left;
@@ -414,8 +1180,9 @@ int rbtree_erase(rbtree *t, node_t *p) {
     y_color = y->color;
     x = y->right;
     if (y->parent == p) {
-      x->parent = y;
+      x_parent = y;
     } else {
+      x_parent = y->parent;
       rbtree_transplant__(t, y, y->right);
       y->right = p->right;
       y->right->parent = y;
@@ -427,11 +1194,19 @@ int rbtree_erase(rbtree *t, node_t *p) {
     y->color = p->color;
   }
 
+#ifdef RBTREE_INTERVAL
+  // x의 부모부터 루트까지가 서브트리 구성이 바뀐 노드들입니다.
+  for (node_t *c = x_parent; c != t->nil; c = c->parent) {
+    rbtree_update_max__(c);
+  }
+#endif
+
   if (y_color == RBTREE_BLACK) {
-    rbtree_erase_fixup__(t, x);
+    rbtree_erase_fixup__(t, x, x_parent);
   }
 
-  free(p);
+  t->size--;
+  rbtree_free_node__(t, p);
   return 0;
 }
 
@@ -457,12 +1232,26 @@ int rbtree_to_array_inorder__(const rbtree *t, node_t *n, key_t *arr, size_t idx
     return -1;
   }
 
+  if (n->dead) {
+    return rbtree_to_array_inorder__(t, n->right, arr, idx, len);
+  }
+
+  if (idx >= len) {
+    return -1;
+  }
+
   arr[idx++] = n->key;
   idx = rbtree_to_array_inorder__(t, n->right, arr, idx, len);
 
   return idx;
 }
 
+static int rbtree_key_comp__(const void *p1, const void *p2) {
+  const key_t e1 = *(const key_t *)p1;
+  const key_t e2 = *(const key_t *)p2;
+  return (e1 > e2) - (e1 < e2);
+}
+
 /**
  * @brief rbtree를 중위 순회 순서로 배열에 씁니다.
  * @param[in] t: 대상 rbtree
@@ -470,10 +1259,292 @@ int rbtree_to_array_inorder__(const rbtree *t, node_t *n, key_t *arr, size_t idx
  * @param[in] n: 배열의 길이
  */
 int rbtree_to_array(const rbtree *t, key_t *arr, const size_t n) {
-  rbtree_to_array_inorder__(t, t->root, arr, 0, n);
+  rbtree_notify__(t, RBTREE_OP_TO_ARRAY, (n > INT_MAX) ? INT_MAX : (key_t)n);
+
+  if (t->buf_len == 0) {
+    rbtree_to_array_inorder__(t, t->root, arr, 0, n);
+    return 0;
+  }
+
+  key_t *buffered = (key_t *)malloc(t->buf_len * sizeof(key_t));
+  if (buffered == NULL) {
+    return -1;
+  }
+
+  memcpy(buffered, t->buf_keys, t->buf_len * sizeof(key_t));
+  qsort(buffered, t->buf_len, sizeof(key_t), rbtree_key_comp__);
+
+  // rbtree의 중위 순회와 정렬된 버퍼를 병합합니다.
+  size_t idx = 0, b = 0;
+  node_t *cursor = (t->root == t->nil) ? t->nil : rbtree_sub_min__(t, t->root);
+  while (idx < n && (cursor != t->nil || b < t->buf_len)) {
+    if (cursor != t->nil && cursor->dead) {
+      cursor = rbtree_next__(t, cursor);
+      continue;
+    }
+
+    if (cursor != t->nil && (b == t->buf_len || cursor->key <= buffered[b])) {
+      arr[idx++] = cursor->key;
+      cursor = rbtree_next__(t, cursor);
+    } else {
+      arr[idx++] = buffered[b++];
+    }
+  }
+
+  free(buffered);
   return 0;
 }
 
+#ifdef RBTREE_INTERVAL
+/**
+ * @brief 구간 [lo, hi]를 rbtree에 삽입합니다. 노드의 key는 lo가 됩니다.
+ * @param[in] t: 대상 rbtree
+ * @param[in] lo: 구간의 시작점
+ * @param[in] hi: 구간의 끝점
+ * @return 삽입한 노드의 포인터를 반환하고, lo > hi 이면 @b NULL 을 반환합니다.
+ */
+node_t *rbtree_insert_interval(rbtree *t, const key_t lo, const key_t hi) {
+  if (lo > hi) {
+    return NULL;
+  }
+
+  // hook에는 시작점을 키로 하는 삽입으로 기록됩니다.
+  rbtree_begin_insert__(t, lo);
+  node_t *node = new_node__(t, lo);
+  if (node == NULL) {
+    return NULL;
+  }
+
+  node->hi = hi;
+  node->max = hi;
+  rbtree_insert_node__(t, node);
+  return node;
+}
+
+/**
+ * @brief 구간 [lo, hi]와 겹치는 노드를 중위 순회 순서로 배열에 씁니다.
+ * @param[in] t: 대상 rbtree
+ * @param[in] n: 현재 노드
+ * @param[in] lo: 구간의 시작점
+ * @param[in] hi: 구간의 끝점
+ * @param[out] arr: 겹치는 노드를 저장할 배열
+ * @param[in] idx: 배열의 현재 인덱스
+ * @param[in] len: 배열의 길이
+ * @return 다음에 쓸 배열의 인덱스를 반환합니다.
+ */
+static size_t rbtree_overlaps_inorder__(const rbtree *t, node_t *n, key_t lo, key_t hi, node_t **arr,
+                                        size_t idx, const size_t len) {
+  // 서브트리의 모든 구간이 lo 전에 끝나면 더 볼 필요가 없습니다.
+  if (n == t->nil || n->max < lo || idx >= len) {
+    return idx;
+  }
+
+  idx = rbtree_overlaps_inorder__(t, n->left, lo, hi, arr, idx, len);
+
+  // n과 오른쪽 서브트리의 구간은 모두 hi 이후에 시작합니다.
+  if (n->key > hi || idx >= len) {
+    return idx;
+  }
+
+  if (lo <= n->hi && !n->dead) {
+    arr[idx++] = n;
+  }
+
+  return rbtree_overlaps_inorder__(t, n->right, lo, hi, arr, idx, len);
+}
+
+/**
+ * @brief 구간 [lo, hi]와 겹치는 모든 노드를 시작점 순서로 배열에 씁니다.
+ *
+ * 시작점으로 정렬한 rbtree에서 서브트리의 끝점 최댓값으로 가지치기하므로, 겹치는 노드 k개를 찾는 데
+ * O(min(n, k log n))이 걸립니다. 찾은 노드마다 겹치지 않는 조상을 루트까지 거칠 수 있어 O(log n + k)는
+ * 보장하지 않습니다. tombstone도 겹치면 방문하므로 k에 포함됩니다.
+ * @param[in] t: 대상 rbtree
+ * @param[in] lo: 구간의 시작점
+ * @param[in] hi: 구간의 끝점
+ * @param[out] arr: 겹치는 노드를 저장할 배열
+ * @param[in] n: 배열의 길이
+ * @return 배열에 쓴 노드의 수를 반환합니다.
+ */
+int rbtree_find_overlaps(const rbtree *t, const key_t lo, const key_t hi, node_t **arr, const size_t n) {
+  if (lo > hi) {
+    return 0;
+  }
+
+  return (int)rbtree_overlaps_inorder__(t, t->root, lo, hi, arr, 0, n);
+}
+
+/**
+ * @brief 구간 [lo, hi]와 겹치는 노드를 하나 찾습니다.
+ * @param[in] t: 대상 rbtree
+ * @param[in] lo: 구간의 시작점
+ * @param[in] hi: 구간의 끝점
+ * @return 찾았다면 노드의 포인터를 반환하고 찾지 못했다면 @b NULL 을 반환합니다.
+ */
+node_t *rbtree_find_overlap(const rbtree *t, const key_t lo, const key_t hi) {
+  // tombstone이 있다면 겹치는 구간이 tombstone 뒤에 가려질 수 있으므로 열거로 찾습니다.
+  if (t->dead > 0) {
+    node_t *found;
+    return (rbtree_find_overlaps(t, lo, hi, &found, 1) == 1) ? found : NULL;
+  }
+
+  node_t *cursor = t->root;
+  while (cursor != t->nil) {
+    if (cursor->key <= hi && lo <= cursor->hi) {
+      return cursor;
+    }
+
+    // 왼쪽 서브트리에 lo 이상에서 끝나는 구간이 있다면 겹치는 구간은 왼쪽에도 있거나 어디에도 없습니다.
+    if (cursor->left != t->nil && cursor->left->max >= lo) {
+      cursor = cursor->left;
+      continue;
+    }
+    cursor = cursor->right;
+  }
+
+  return NULL;
+}
+
+/**
+ * @brief 점 point를 포함하는 모든 노드를 시작점 순서로 배열에 씁니다.
+ * @param[in] t: 대상 rbtree
+ * @param[in] point: 찌를 점
+ * @param[out] arr: point를 포함하는 노드를 저장할 배열
+ * @param[in] n: 배열의 길이
+ * @return 배열에 쓴 노드의 수를 반환합니다.
+ */
+int rbtree_stab(const rbtree *t, const key_t point, node_t **arr, const size_t n) {
+  return rbtree_find_overlaps(t, point, point, arr, n);
+}
+#endif  // RBTREE_INTERVAL
+
+/**
+ * @brief 바이트 키의 앞 8바이트를 big-endian 정수로 만듭니다.
+ *
+ * 8바이트보다 짧은 키는 0으로 채우므로 접두사가 다르면 정수 비교 결과가 바이트 비교 결과와 같습니다.
+ * @param[in] key: 바이트 키
+ * @param[in] len: 키의 길이
+ */
+static inline uint64_t rbtree_bytes_prefix__(const unsigned char *key, size_t len) {
+  uint64_t prefix = 0;
+  for (size_t i = 0; i < RBTREE_BYTES_PREFIX; ++i) {
+    prefix = (prefix << 8) | ((i < len) ? key[i] : 0);
+  }
+
+  return prefix;
+}
+
+/**
+ * @brief 바이트 키와 노드의 키를 비교합니다.
+ * @param[in] prefix: rbtree_bytes_prefix__()로 만든 key의 접두사
+ * @param[in] key: 바이트 키
+ * @param[in] len: 키의 길이
+ * @param[in] n: 비교할 노드
+ * @return key가 작으면 음수, 같으면 0, 크면 양수를 반환합니다.
+ */
+static inline int rbtree_bytes_cmp__(uint64_t prefix, const unsigned char *key, size_t len, const bnode_t *n) {
+#ifndef RBTREE_BYTES_NO_PREFIX
+  // 대부분의 비교는 노드 안의 접두사만으로 끝나고 키 본문을 읽지 않습니다.
+  if (prefix != n->prefix) {
+    return (prefix < n->prefix) ? -1 : 1;
+  }
+
+  // 접두사가 같다면 앞의 min(len, 8) 바이트는 이미 같습니다.
+  const size_t skip = RBTREE_BYTES_PREFIX;
+#else
+  const size_t skip = 0;
+#endif
+  const size_t common = (len < n->len) ? len : n->len;
+  if (common > skip) {
+    int cmp = memcmp(key + skip, n->key + skip, common - skip);
+    if (cmp != 0) {
+      return cmp;
+    }
+  }
+
+  return (len > n->len) - (len < n->len);
+}
+
+/**
+ * @brief 바이트 키를 rbtree에 삽입합니다. 키는 노드와 함께 한 번에 할당된 공간에 복사됩니다.
+ * @param[in] t: 대상 rbtree, 정수 키와 바이트 키를 한 rbtree에 섞어 쓸 수 없습니다.
+ * @param[in] key: 바이트 키
+ * @param[in] len: 키의 길이
+ * @return 삽입한 노드의 포인터를 반환합니다. bnode_t 포인터로 변환해 키를 읽을 수 있습니다.
+ */
+node_t *rbtree_insert_bytes(rbtree *t, const void *key, const size_t len) {
+  bnode_t *b = (bnode_t *)calloc(1, sizeof(bnode_t) + len);
+  if (b == NULL) {
+    return NULL;
+  }
+  t->bytes = 1;
+
+  b->prefix = rbtree_bytes_prefix__((const unsigned char *)key, len);
+  b->len = len;
+  memcpy(b->key, key, len);
+
+  node_t *node = &b->node;
+  node->color = RBTREE_RED;
+  node->left = t->nil;
+  node->right = t->nil;
+
+  node_t *parent = t->nil;
+  node_t *cursor = t->root;
+  int cmp = 0;
+  while (cursor != t->nil) {
+    parent = cursor;
+    cmp = rbtree_bytes_cmp__(b->prefix, b->key, len, (const bnode_t *)cursor);
+    cursor = (cmp < 0) ? cursor->left : cursor->right;
+  }
+
+  rbtree_link_node__(t, parent, node, cmp < 0);
+  return node;
+}
+
+/**
+ * @brief 서브트리에서 바이트 키가 같고 tombstone이 아닌 노드를 찾습니다.
+ * @param[in] t: 대상 rbtree
+ * @param[in] n: 대상 서브트리의 루트
+ * @param[in] prefix: 키의 접두사
+ * @param[in] key: 바이트 키
+ * @param[in] len: 키의 길이
+ * @return 찾았다면 노드의 포인터를 반환하고 찾지 못했다면 @b NULL 을 반환합니다.
+ */
+static node_t *rbtree_find_bytes__(const rbtree *t, node_t *n, uint64_t prefix, const unsigned char *key,
+                                   size_t len) {
+  while (n != t->nil) {
+    int cmp = rbtree_bytes_cmp__(prefix, key, len, (const bnode_t *)n);
+    if (cmp == 0) {
+      if (!n->dead) {
+        return n;
+      }
+
+      node_t *found = rbtree_find_bytes__(t, n->left, prefix, key, len);
+      if (found != NULL) {
+        return found;
+      }
+      n = n->right;
+      continue;
+    }
+
+    n = (cmp < 0) ? n->left : n->right;
+  }
+
+  return NULL;
+}
+
+/**
+ * @brief rbtree에 바이트 키가 같은 노드를 찾습니다.
+ * @param[in] t: 대상 rbtree
+ * @param[in] key: 바이트 키
+ * @param[in] len: 키의 길이
+ * @return 찾았다면 노드의 포인터를 반환하고 찾지 못했다면 @b NULL 을 반환합니다.
+ */
+node_t *rbtree_find_bytes(const rbtree *t, const void *key, const size_t len) {
+  const unsigned char *k = (const unsigned char *)key;
+  return rbtree_find_bytes__(t, t->root, rbtree_bytes_prefix__(k, len), k, len);
+}
+
 /**
  * @brief rbtree를 스트림에 출력합니다.
  * @param[out] stream: 대상 stream
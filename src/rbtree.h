@@ -2,22 +2,112 @@
 #define _RBTREE_H_
 
 #include <stddef.h>
+#include <stdint.h>
 #include <stdio.h>
 
 typedef enum { RBTREE_RED, RBTREE_BLACK } color_t;
 
 typedef int key_t;
 
+#if defined(RBTREE_BTREE)
+// B-tree 백엔드의 키 핸들. 키는 B-tree 노드에 있고 핸들은 rbtree_erase()에 넘길 항목을 가리킬 뿐입니다.
+typedef struct node_t {
+  key_t key;
+} node_t;
+#elif defined(RBTREE_NOPARENT)
+// 부모 포인터가 없는 변형 (src/rbtree-np.c). 확장 기능이 쓰는 필드도 없습니다.
 typedef struct node_t {
   color_t color;
   key_t key;
+  struct node_t *left, *right;
+} node_t;
+#else
+typedef struct node_t {
+  unsigned char color;  // color_t, dead와 함께 key 앞의 4바이트에 넣습니다.
+  unsigned char dead;   // 지연 삭제 모드에서 삭제 표시된 노드(tombstone)
+  key_t key;
+#ifdef RBTREE_INTERVAL
+  key_t hi;   // 구간 [key, hi]의 끝점, 점 키는 hi == key
+  key_t max;  // 서브트리에 있는 구간 끝점의 최댓값
+#endif
   struct node_t *parent, *left, *right;
 } node_t;
+#endif
+
+// 바이트 키 노드는 키의 앞 RBTREE_BYTES_PREFIX 바이트를 정수로 함께 저장합니다.
+#define RBTREE_BYTES_PREFIX 8
+
+typedef struct {
+  node_t node;      // 첫 멤버여야 합니다.
+  uint64_t prefix;  // 키의 앞 8바이트 (big-endian, 0으로 채움)
+  size_t len;
+  unsigned char key[];
+} bnode_t;
+
+typedef enum {
+  RBTREE_OP_INSERT,
+  RBTREE_OP_FIND,
+  RBTREE_OP_ERASE,
+  RBTREE_OP_MIN,
+  RBTREE_OP_MAX,
+  RBTREE_OP_TO_ARRAY
+} rbtree_op_t;
+
+// 연산이 호출될 때마다 불리는 hook. arg는 키 (to_array는 배열 길이)
+// 구간 삽입은 시작점을 키로 하는 INSERT로 불립니다. 바이트 키 연산과 구간 질의는 hook을 부르지 않습니다.
+typedef void (*rbtree_hook_t)(void *ctx, rbtree_op_t op, key_t arg);
+
+#ifdef RBTREE_BTREE
+// B-tree 백엔드 (src/btree.c). node_t는 키를 가리키는 핸들로만 쓰입니다.
+typedef struct btree_node_t btree_node_t;
+typedef struct btree_arena_t btree_arena_t;
+
+typedef struct {
+  btree_node_t *root;
+  uint32_t root_id;      // 노드 저장소 안에서 루트의 번호
+  btree_arena_t *arena;  // B-tree 노드를 32비트 번호로 가리키기 위한 저장소
+  size_t size;
+  rbtree_hook_t hook;
+  void *hook_ctx;
+} rbtree;
+#elif defined(RBTREE_NOPARENT)
+typedef struct {
+  node_t *root;
+  node_t *nil;  // for sentinel
+  rbtree_hook_t hook;
+  void *hook_ctx;
+  size_t size;
+} rbtree;
+#else
+// rbtree_find() 앞에 두는 direct-mapped 캐시. 키의 해시로 고른 칸에 최근에 찾은 노드를 둡니다.
+typedef struct {
+  unsigned shift;  // 해시의 상위 비트를 칸 번호로 쓰기 위한 shift
+  size_t hits;
+  size_t misses;
+  node_t *slots[];
+} rbtree_cache_t;
 
 typedef struct {
   node_t *root;
   node_t *nil;  // for sentinel
+  rbtree_hook_t hook;
+  void *hook_ctx;
+  size_t size;        // tombstone을 포함한 노드 수
+  size_t dead;        // tombstone 수
+  double lazy_ratio;  // 0이 아니면 지연 삭제 모드, tombstone 비율이 이 값을 넘으면 재구성
+  node_t **buf;       // 삽입 버퍼, 아직 rbtree에 연결되지 않은 노드 (parent == NULL)
+  key_t *buf_keys;    // buf와 같은 순서의 키
+  size_t buf_len;
+  size_t buf_cap;  // 0이면 삽입 버퍼를 쓰지 않음
+  unsigned char bytes;    // rbtree_insert_bytes()로 삽입한 적이 있으면 1
+  rbtree_cache_t *cache;  // NULL이면 find 캐시를 쓰지 않음, 있으면 rbtree_find()가 고치므로 동시에 읽을 수 없음
+  node_t *pool;           // 노드 pool, 처음에는 pool_inline이고 rbtree_compact() 후에는 따로 할당한 블록
+  size_t pool_cap;        // pool의 노드 수
+  size_t pool_used;       // pool에서 한 번이라도 쓴 노드 수
+  node_t *pool_free;      // pool에서 해제된 노드 목록 (parent로 연결)
+  node_t pool_inline[];   // rbtree와 함께 할당된 노드, new_rbtree_small()로 수를 정합니다.
 } rbtree;
+#endif
 
 rbtree *new_rbtree(void);
 void delete_rbtree(rbtree *);
@@ -30,4 +120,29 @@ int rbtree_erase(rbtree *, node_t *);
 
 int rbtree_to_array(const rbtree *, key_t *, const size_t);
 int rbtree_print(FILE *, const rbtree *);
+
+void rbtree_set_hook(rbtree *, rbtree_hook_t, void *);
+
+#if !defined(RBTREE_BTREE) && !defined(RBTREE_NOPARENT)
+#ifdef RBTREE_INTERVAL
+// 구간 모드. 모든 소스를 -DRBTREE_INTERVAL로 컴파일해야 노드가 구간 끝점을 가집니다.
+node_t *rbtree_insert_interval(rbtree *, const key_t, const key_t);
+node_t *rbtree_find_overlap(const rbtree *, const key_t, const key_t);
+int rbtree_find_overlaps(const rbtree *, const key_t, const key_t, node_t **, const size_t);
+int rbtree_stab(const rbtree *, const key_t, node_t **, const size_t);
+#endif
+
+node_t *rbtree_insert_bytes(rbtree *, const void *, const size_t);
+node_t *rbtree_find_bytes(const rbtree *, const void *, const size_t);
+
+int rbtree_set_lazy_erase(rbtree *, double);
+int rbtree_set_insert_buffer(rbtree *, size_t);
+void rbtree_flush(rbtree *);
+int rbtree_set_find_cache(rbtree *, size_t);
+
+rbtree *new_rbtree_small(size_t);
+rbtree *rbtree_clone(const rbtree *);
+int rbtree_delete_incremental(rbtree *, size_t);
+int rbtree_compact(rbtree *);
+#endif
 #endif  // _RBTREE_H_
@@ -0,0 +1,113 @@
+#include "trace.h"
+
+#include <stdint.h>
+#include <string.h>
+
+/**
+ * @brief 스트림에 트레이스 헤더를 씁니다.
+ * @param[out] stream: 트레이스를 기록할 stream
+ * @return 성공하면 0, 실패하면 -1을 반환합니다.
+ */
+int rbtree_trace_begin(FILE *stream) {
+  if (stream == NULL) {
+    return -1;
+  }
+
+  if (fwrite(RBTREE_TRACE_MAGIC, 1, 4, stream) != 4) {
+    return -1;
+  }
+
+  if (fputc(RBTREE_TRACE_VERSION, stream) == EOF) {
+    return -1;
+  }
+
+  return 0;
+}
+
+/**
+ * @brief 연산 하나를 레코드로 기록합니다. rbtree_set_hook()에 그대로 넘길 수 있습니다.
+ *
+ * hook은 실패를 돌려줄 수 없으므로, 쓰기에 실패하면 stream의 오류 표시를 남기고 이후 레코드는 쓰지 않습니다.
+ * 기록을 마칠 때 rbtree_trace_end()로 실패 여부를 확인해야 합니다.
+ * @param[in] ctx: 레코드를 쓸 FILE 포인터
+ * @param[in] op: 연산 종류
+ * @param[in] arg: 연산의 인자
+ */
+void rbtree_trace_hook(void *ctx, rbtree_op_t op, key_t arg) {
+  uint32_t v = (uint32_t)arg;
+  unsigned char rec[RBTREE_TRACE_RECORD_SIZE] = {
+    (unsigned char)op,
+    (unsigned char)(v & 0xff),
+    (unsigned char)((v >> 8) & 0xff),
+    (unsigned char)((v >> 16) & 0xff),
+    (unsigned char)((v >> 24) & 0xff),
+  };
+
+  FILE *stream = (FILE *)ctx;
+  if (ferror(stream)) {
+    return;
+  }
+
+  // 짧게 쓰이면 fwrite가 stream의 오류 표시를 켜므로, 일부만 쓰인 레코드 뒤로는 더 쓰지 않습니다.
+  fwrite(rec, 1, sizeof(rec), stream);
+}
+
+/**
+ * @brief 트레이스 기록을 마치고 stream을 닫습니다.
+ * @param[in] stream: 트레이스를 기록한 stream
+ * @return 모든 레코드를 썼다면 0, 쓰기에 실패한 적이 있다면 -1을 반환합니다.
+ */
+int rbtree_trace_end(FILE *stream) {
+  if (stream == NULL) {
+    return -1;
+  }
+
+  int failed = ferror(stream) || fflush(stream) != 0;
+  if (fclose(stream) != 0) {
+    failed = 1;
+  }
+
+  return failed ? -1 : 0;
+}
+
+/**
+ * @brief 스트림의 트레이스 헤더를 읽고 검사합니다.
+ * @param[in] stream: 트레이스를 읽을 stream
+ * @return 올바른 트레이스라면 0, 그렇지 않으면 -1을 반환합니다.
+ */
+int rbtree_trace_check(FILE *stream) {
+  char magic[4];
+  if (stream == NULL || fread(magic, 1, 4, stream) != 4) {
+    return -1;
+  }
+
+  if (memcmp(magic, RBTREE_TRACE_MAGIC, 4) != 0) {
+    return -1;
+  }
+
+  return (fgetc(stream) == RBTREE_TRACE_VERSION) ? 0 : -1;
+}
+
+/**
+ * @brief 다음 레코드를 읽습니다.
+ * @param[in] stream: 트레이스를 읽을 stream
+ * @param[out] op: 연산 종류
+ * @param[out] arg: 연산의 인자
+ * @return 레코드를 읽었다면 1, 트레이스의 끝이면 0, 잘못된 레코드라면 -1을 반환합니다.
+ */
+int rbtree_trace_next(FILE *stream, rbtree_op_t *op, key_t *arg) {
+  unsigned char rec[RBTREE_TRACE_RECORD_SIZE];
+  size_t len = fread(rec, 1, sizeof(rec), stream);
+  if (len == 0) {
+    return 0;
+  }
+
+  if (len != sizeof(rec) || rec[0] > RBTREE_OP_TO_ARRAY) {
+    return -1;
+  }
+
+  *op = (rbtree_op_t)rec[0];
+  *arg = (key_t)((uint32_t)rec[1] | ((uint32_t)rec[2] << 8) | ((uint32_t)rec[3] << 16) |
+                 ((uint32_t)rec[4] << 24));
+  return 1;
+}
@@ -0,0 +1,20 @@
+#ifndef _TRACE_H_
+#define _TRACE_H_
+
+#include <stdio.h>
+
+#include "rbtree.h"
+
+// 트레이스 파일 = 헤더(magic 4바이트 + version 1바이트) + 레코드의 나열
+// 레코드 = 연산 1바이트 + 인자 4바이트(little-endian)
+#define RBTREE_TRACE_MAGIC "RBTR"
+#define RBTREE_TRACE_VERSION 1
+#define RBTREE_TRACE_RECORD_SIZE 5
+
+int rbtree_trace_begin(FILE *);
+void rbtree_trace_hook(void *, rbtree_op_t, key_t);
+int rbtree_trace_end(FILE *);
+
+int rbtree_trace_check(FILE *);
+int rbtree_trace_next(FILE *, rbtree_op_t *, key_t *);
+#endif  // _TRACE_H_
@@ -1,8 +1,10 @@
 #include <assert.h>
+#include <limits.h>
 #include <rbtree.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 // new_rbtree should return rbtree struct with null root node
 void test_init(void) {
@@ -17,6 +19,9 @@ void test_init(void) {
   delete_rbtree(t);
 }
 
+// The B-tree backend has no node structure to inspect, only key handles.
+// The no-parent variant has nodes but no parent pointer.
+#if !defined(RBTREE_BTREE) && !defined(RBTREE_NOPARENT)
 // root node should have proper values and pointers
 void test_insert_single(const key_t key) {
   rbtree *t = new_rbtree();
@@ -36,6 +41,7 @@ void test_insert_single(const key_t key) {
 #endif
   delete_rbtree(t);
 }
+#endif  // RBTREE_BTREE, RBTREE_NOPARENT
 
 // find should return the node with the key or NULL if no such node exists
 void test_find_single(const key_t key, const key_t wrong_key) {
@@ -53,6 +59,7 @@ void test_find_single(const key_t key, const key_t wrong_key) {
   delete_rbtree(t);
 }
 
+#ifndef RBTREE_BTREE
 // erase should delete root node
 void test_erase_root(const key_t key) {
   rbtree *t = new_rbtree();
@@ -70,6 +77,7 @@ void test_erase_root(const key_t key) {
 
   delete_rbtree(t);
 }
+#endif  // RBTREE_BTREE
 
 static void insert_arr(rbtree *t, const key_t *arr, const size_t n) {
   for (size_t i = 0; i < n; i++) {
@@ -175,6 +183,7 @@ void test_multi_instance() {
   delete_rbtree(t1);
 }
 
+#ifndef RBTREE_BTREE
 // Search tree constraint
 // The values of left subtree should be less than or equal to the current node
 // The values of right subtree should be greater than or equal to the current
@@ -293,6 +302,28 @@ void test_duplicate_values() {
   test_rb_constraints(entries, n);
 }
 
+// rbtree should keep both constraints after every erase of a random node
+void test_erase_constraints_rand(const size_t n, const unsigned int seed) {
+  srand(seed);
+  rbtree *t = new_rbtree();
+  node_t **nodes = calloc(n, sizeof(node_t *));
+  for (size_t i = 0; i < n; i++) {
+    nodes[i] = rbtree_insert(t, rand() % (n / 8 + 1));
+  }
+
+  for (size_t live = n; live > 0;) {
+    const size_t victim = rand() % live;
+    assert(rbtree_erase(t, nodes[victim]) == 0);
+    nodes[victim] = nodes[--live];
+    test_color_constraint(t);
+    test_search_constraint(t);
+  }
+
+  free(nodes);
+  delete_rbtree(t);
+}
+#endif  // RBTREE_BTREE
+
 void test_minmax_suite() {
   key_t entries[] = {10, 5, 8, 34, 67, 23, 156, 24, 2, 12};
   const size_t n = sizeof(entries) / sizeof(entries[0]);
@@ -367,17 +398,714 @@ void test_find_erase_rand(const size_t n, const unsigned int seed) {
   delete_rbtree(t);
 }
 
+// erasing arbitrary nodes among many duplicates should keep the remaining keys
+void test_erase_duplicates_rand(const size_t n, const unsigned int seed) {
+  srand(seed);
+  rbtree *t = new_rbtree();
+  node_t **nodes = calloc(n, sizeof(node_t *));
+  key_t *keys = calloc(n, sizeof(key_t));
+  key_t *res = calloc(n, sizeof(key_t));
+  for (size_t i = 0; i < n; i++) {
+    rbtree_insert(t, rand() % (n / 8));
+  }
+  // collect one node per key through find and erase
+  for (size_t i = 0; i < n; i++) {
+    nodes[i] = rbtree_min(t);
+    assert(nodes[i] != NULL);
+    keys[i] = nodes[i]->key;
+    rbtree_erase(t, nodes[i]);
+  }
+  assert(rbtree_min(t) == NULL);
+  for (size_t i = 1; i < n; i++) {
+    assert(keys[i - 1] <= keys[i]);
+  }
+
+  for (size_t i = 0; i < n; i++) {
+    nodes[i] = rbtree_insert(t, keys[i]);
+    assert(nodes[i] != NULL && nodes[i]->key == keys[i]);
+  }
+  size_t live = n;
+  while (live > 0) {
+    const size_t victim = rand() % live;
+    assert(rbtree_erase(t, nodes[victim]) == 0);
+    nodes[victim] = nodes[live - 1];
+    keys[victim] = keys[live - 1];
+    live--;
+
+    if (live % 101 == 0) {
+      key_t *sorted = calloc(live + 1, sizeof(key_t));
+      memcpy(sorted, keys, live * sizeof(key_t));
+      qsort((void *)sorted, live, sizeof(key_t), comp);
+      rbtree_to_array(t, res, live);
+      for (size_t i = 0; i < live; i++) {
+        assert(res[i] == sorted[i]);
+      }
+      free(sorted);
+    }
+  }
+
+  free(res);
+  free(keys);
+  free(nodes);
+  delete_rbtree(t);
+}
+
+typedef struct {
+  int count;
+  rbtree_op_t last_op;
+  key_t last_arg;
+} hook_log_t;
+
+static void count_hook(void *ctx, rbtree_op_t op, key_t arg) {
+  hook_log_t *log = (hook_log_t *)ctx;
+  log->count++;
+  log->last_op = op;
+  log->last_arg = arg;
+}
+
+// hook should be called once per public operation with its argument
+void test_hook() {
+  rbtree *t = new_rbtree();
+  hook_log_t log = {0};
+  rbtree_set_hook(t, count_hook, &log);
+
+  rbtree_insert(t, 42);
+  assert(log.count == 1 && log.last_op == RBTREE_OP_INSERT && log.last_arg == 42);
+  node_t *p = rbtree_find(t, 42);
+  assert(log.count == 2 && log.last_op == RBTREE_OP_FIND && log.last_arg == 42);
+  rbtree_min(t);
+  assert(log.count == 3 && log.last_op == RBTREE_OP_MIN);
+  rbtree_max(t);
+  assert(log.count == 4 && log.last_op == RBTREE_OP_MAX);
+  key_t arr[4];
+  rbtree_to_array(t, arr, 4);
+  assert(log.count == 5 && log.last_op == RBTREE_OP_TO_ARRAY && log.last_arg == 4);
+  rbtree_erase(t, p);
+  assert(log.count == 6 && log.last_op == RBTREE_OP_ERASE && log.last_arg == 42);
+
+  rbtree_set_hook(t, NULL, NULL);
+  rbtree_insert(t, 7);
+  assert(log.count == 6);
+
+  delete_rbtree(t);
+}
+
+#if !defined(RBTREE_BTREE) && !defined(RBTREE_NOPARENT)
+#ifdef RBTREE_INTERVAL
+// Interval constraint
+// Each node keeps the maximum end point of the intervals in its subtree.
+
+static key_t max_traverse(const node_t *p, node_t *nil, bool *ok) {
+  if (p == nil) {
+    return INT_MIN;
+  }
+
+  key_t max = p->hi;
+  key_t l = max_traverse(p->left, nil, ok);
+  key_t r = max_traverse(p->right, nil, ok);
+  max = (l > max) ? l : max;
+  max = (r > max) ? r : max;
+  if (p->max != max) {
+    *ok = false;
+  }
+  return max;
+}
+
+static size_t count_overlaps(node_t **nodes, const size_t n, const key_t lo, const key_t hi) {
+  size_t cnt = 0;
+  for (size_t i = 0; i < n; i++) {
+    if (nodes[i]->key <= hi && lo <= nodes[i]->hi) {
+      cnt++;
+    }
+  }
+  return cnt;
+}
+
+// interval queries should match a linear scan after inserts and erases
+void test_interval_rand(const size_t n, const unsigned int seed) {
+  srand(seed);
+  rbtree *t = new_rbtree();
+  node_t **nodes = calloc(n, sizeof(node_t *));
+  node_t **res = calloc(n, sizeof(node_t *));
+  for (size_t i = 0; i < n; i++) {
+    const key_t lo = rand() % 10000;
+    nodes[i] = rbtree_insert_interval(t, lo, lo + rand() % 100);
+    assert(nodes[i] != NULL);
+  }
+  assert(rbtree_insert_interval(t, 5, 4) == NULL);
+
+  size_t live = n;
+  for (size_t i = 0; i < n / 2; i++) {
+    const size_t victim = rand() % live;
+    rbtree_erase(t, nodes[victim]);
+    nodes[victim] = nodes[--live];
+  }
+
+#ifdef SENTINEL
+  node_t *nil = t->nil;
+#else
+  node_t *nil = NULL;
+#endif
+  bool ok = true;
+  max_traverse(t->root, nil, &ok);
+  assert(ok);
+  test_color_constraint(t);
+  test_search_constraint(t);
+
+  for (int i = 0; i < 200; i++) {
+    const key_t lo = rand() % 10200 - 100;
+    const key_t hi = lo + rand() % 50;
+    const size_t expected = count_overlaps(nodes, live, lo, hi);
+
+    const int cnt = rbtree_find_overlaps(t, lo, hi, res, n);
+    assert(cnt == expected);
+    for (int j = 0; j < cnt; j++) {
+      assert(res[j]->key <= hi && lo <= res[j]->hi);
+      assert(j == 0 || res[j - 1]->key <= res[j]->key);
+    }
+
+    node_t *p = rbtree_find_overlap(t, lo, hi);
+    assert((p != NULL) == (expected > 0));
+    assert(p == NULL || (p->key <= hi && lo <= p->hi));
+
+    assert(rbtree_stab(t, lo, res, n) == count_overlaps(nodes, live, lo, lo));
+  }
+
+  // the output array bounds the number of reported nodes
+  if (live > 0) {
+    assert(rbtree_find_overlaps(t, INT_MIN, INT_MAX, res, 1) == 1);
+  }
+
+  // interval inserts are observed by the hook and drop the cached node for their start point
+  hook_log_t log = {0};
+  rbtree_set_hook(t, count_hook, &log);
+  assert(rbtree_set_find_cache(t, 16) == 0);
+  rbtree_insert(t, 20000);
+  rbtree_find(t, 20000);
+  const size_t misses = t->cache->misses;
+  rbtree_insert_interval(t, 20000, 20010);
+  assert(log.last_op == RBTREE_OP_INSERT && log.last_arg == 20000);
+  assert(rbtree_find(t, 20000)->key == 20000);
+  assert(t->cache->misses == misses + 1);
+
+  free(res);
+  free(nodes);
+  delete_rbtree(t);
+}
+#endif  // RBTREE_INTERVAL
+
+// lazy erase should hide tombstones from every query and compact them later
+void test_lazy_erase(const size_t n, const unsigned int seed) {
+  srand(seed);
+  rbtree *t = new_rbtree();
+  assert(rbtree_set_lazy_erase(t, 1.0) == -1);
+  assert(rbtree_set_lazy_erase(t, 0.25) == 0);
+
+  key_t *arr = calloc(n, sizeof(key_t));
+  key_t *res = calloc(n, sizeof(key_t));
+  for (size_t i = 0; i < n; i++) {
+    arr[i] = rand() % (n / 4);  // many duplicates
+    rbtree_insert(t, arr[i]);
+  }
+
+  size_t live = n;
+  bool rebuilt = false;
+  while (live > n / 8) {
+    const size_t victim = rand() % live;
+    node_t *p = rbtree_find(t, arr[victim]);
+    assert(p != NULL && !p->dead && p->key == arr[victim]);
+    const size_t dead = t->dead;
+    assert(rbtree_erase(t, p) == 0);
+    rebuilt = rebuilt || t->dead < dead;
+    arr[victim] = arr[--live];
+
+    if (live % 97 == 0) {
+      qsort((void *)arr, live, sizeof(key_t), comp);
+      assert(rbtree_to_array(t, res, live) == 0);
+      for (size_t i = 0; i < live; i++) {
+        assert(res[i] == arr[i]);
+      }
+      assert(rbtree_min(t)->key == arr[0]);
+      assert(rbtree_max(t)->key == arr[live - 1]);
+      test_color_constraint(t);
+      test_search_constraint(t);
+    }
+  }
+  assert(rebuilt);
+  assert(t->size - t->dead == live);
+
+  // erased keys that have no live duplicate should not be found
+  for (key_t k = 0; k < (key_t)(n / 4); k++) {
+    bool exists = false;
+    for (size_t i = 0; i < live; i++) {
+      exists = exists || arr[i] == k;
+    }
+    node_t *p = rbtree_find(t, k);
+    assert(exists == (p != NULL));
+    assert(p == NULL || !p->dead);
+  }
+
+  // turning lazy erase off compacts the remaining tombstones
+  assert(rbtree_set_lazy_erase(t, 0) == 0);
+  assert(t->dead == 0 && t->size == live);
+  test_color_constraint(t);
+  test_search_constraint(t);
+
+  free(res);
+  free(arr);
+  delete_rbtree(t);
+}
+
+static int bytes_comp(const bnode_t *a, const bnode_t *b) {
+  const size_t common = (a->len < b->len) ? a->len : b->len;
+  const int cmp = memcmp(a->key, b->key, common);
+  if (cmp != 0) {
+    return cmp;
+  }
+  return (a->len > b->len) - (a->len < b->len);
+}
+
+static bool bytes_traverse(const node_t *p, const node_t *nil, const bnode_t **prev) {
+  if (p == nil) {
+    return true;
+  }
+  if (!bytes_traverse(p->left, nil, prev)) {
+    return false;
+  }
+  const bnode_t *b = (const bnode_t *)p;
+  if (*prev != NULL && bytes_comp(*prev, b) > 0) {
+    return false;
+  }
+  *prev = b;
+  return bytes_traverse(p->right, nil, prev);
+}
+
+// byte keys should be ordered like memcmp with shorter keys first on ties
+void test_bytes_keys(const size_t n, const unsigned int seed) {
+  srand(seed);
+  rbtree *t = new_rbtree();
+  const char *stems[] = {"", "a", "ab", "https://", "https://example.com/"};
+  const size_t n_stems = sizeof(stems) / sizeof(stems[0]);
+  char (*keys)[32] = calloc(n, sizeof(*keys));
+  size_t *lens = calloc(n, sizeof(size_t));
+  node_t **nodes = calloc(n, sizeof(node_t *));
+
+  for (size_t i = 0; i < n; i++) {
+    const char *stem = stems[rand() % n_stems];
+    const size_t stem_len = strlen(stem);
+    lens[i] = stem_len + rand() % 6;
+    memcpy(keys[i], stem, stem_len);
+    for (size_t j = stem_len; j < lens[i]; j++) {
+      keys[i][j] = "\0ab"[rand() % 3];
+    }
+    nodes[i] = rbtree_insert_bytes(t, keys[i], lens[i]);
+    assert(nodes[i] != NULL);
+    assert(((bnode_t *)nodes[i])->len == lens[i]);
+    assert(memcmp(((bnode_t *)nodes[i])->key, keys[i], lens[i]) == 0);
+  }
+
+#ifdef SENTINEL
+  node_t *nil = t->nil;
+#else
+  node_t *nil = NULL;
+#endif
+  const bnode_t *prev = NULL;
+  assert(bytes_traverse(t->root, nil, &prev));
+  test_color_constraint(t);
+
+  for (size_t i = 0; i < n; i++) {
+    node_t *p = rbtree_find_bytes(t, keys[i], lens[i]);
+    assert(p != NULL);
+    const bnode_t *b = (const bnode_t *)p;
+    assert(b->len == lens[i] && memcmp(b->key, keys[i], lens[i]) == 0);
+  }
+  assert(rbtree_find_bytes(t, "zzz", 3) == NULL);
+  assert(rbtree_find_bytes(t, "https://example.com/zzz", 23) == NULL);
+
+  for (size_t i = 0; i < n; i++) {
+    rbtree_erase(t, nodes[i]);
+  }
+  assert(t->root == nil);
+
+  free(nodes);
+  free(lens);
+  free(keys);
+  delete_rbtree(t);
+}
+
+static void check_to_array(const rbtree *t, key_t *arr, const size_t n) {
+  key_t *res = calloc(n + 1, sizeof(key_t));
+  qsort((void *)arr, n, sizeof(key_t), comp);
+  assert(rbtree_to_array(t, res, n) == 0);
+  for (size_t i = 0; i < n; i++) {
+    assert(res[i] == arr[i]);
+  }
+  free(res);
+}
+
+// buffered inserts should be visible to every query before and after a flush
+void test_insert_buffer(const size_t n, const size_t cap, const unsigned int seed) {
+  srand(seed);
+  rbtree *t = new_rbtree();
+  assert(rbtree_set_insert_buffer(t, cap) == 0);
+
+  key_t *arr = calloc(n, sizeof(key_t));
+  for (size_t i = 0; i < n; i++) {
+    arr[i] = rand() % (n / 2);
+    node_t *p = rbtree_insert(t, arr[i]);
+    assert(p != NULL && p->key == arr[i]);
+    assert(t->buf_len <= cap);
+
+    node_t *q = rbtree_find(t, arr[i]);
+    assert(q != NULL && q->key == arr[i]);
+    if (i % 37 == 0) {
+      check_to_array(t, arr, i + 1);
+      assert(rbtree_min(t)->key == arr[0]);
+      assert(rbtree_max(t)->key == arr[i]);
+    }
+  }
+  assert(t->buf_len > 0);
+
+  // erase both buffered and linked nodes
+  size_t live = n;
+  while (live > n / 2) {
+    const size_t victim = rand() % live;
+    node_t *p = rbtree_find(t, arr[victim]);
+    assert(p != NULL);
+    assert(rbtree_erase(t, p) == 0);
+    arr[victim] = arr[--live];
+  }
+  check_to_array(t, arr, live);
+
+  rbtree_flush(t);
+  assert(t->buf_len == 0);
+  check_to_array(t, arr, live);
+  test_color_constraint(t);
+  test_search_constraint(t);
+
+  // leave some keys in the buffer for delete_rbtree to release
+  for (size_t i = 0; i < cap / 2; i++) {
+    rbtree_insert(t, (key_t)i);
+  }
+  assert(rbtree_set_insert_buffer(t, 0) == 0);
+  assert(t->buf_len == 0 && t->buf == NULL);
+  assert(rbtree_set_insert_buffer(t, cap) == 0);
+  rbtree_insert(t, 1);
+
+  free(arr);
+  delete_rbtree(t);
+}
+
+// find cache should count hits and never return an erased node
+void test_find_cache(const size_t n, const unsigned int seed) {
+  srand(seed);
+  rbtree *t = new_rbtree();
+  assert(rbtree_set_find_cache(t, 100) == 0);
+  assert(t->cache != NULL);
+
+  key_t *arr = calloc(n, sizeof(key_t));
+  for (size_t i = 0; i < n; i++) {
+    arr[i] = rand() % (n / 2);
+    rbtree_insert(t, arr[i]);
+  }
+
+  node_t *p = rbtree_find(t, arr[0]);
+  assert(p != NULL && p->key == arr[0]);
+  const size_t hits = t->cache->hits;
+  assert(rbtree_find(t, arr[0]) == p);
+  assert(t->cache->hits == hits + 1);
+
+  // a new duplicate drops the cached entry for its key
+  rbtree_insert(t, arr[0]);
+  const size_t misses = t->cache->misses;
+  assert(rbtree_find(t, arr[0])->key == arr[0]);
+  assert(t->cache->misses == misses + 1);
+
+  // erase every copy of every key; the cache must forget each erased node
+  assert(rbtree_set_lazy_erase(t, 0.3) == 0);
+  for (size_t i = 0; i < n; i++) {
+    node_t *q;
+    while ((q = rbtree_find(t, arr[i])) != NULL) {
+      assert(q->key == arr[i] && !q->dead);
+      rbtree_erase(t, q);
+    }
+  }
+  assert(rbtree_min(t) == NULL);
+  assert(t->cache->hits > 0 && t->cache->misses > 0);
+
+  assert(rbtree_set_find_cache(t, 0) == 0);
+  assert(t->cache == NULL);
+  free(arr);
+  delete_rbtree(t);
+}
+
+// pooled nodes should behave like heap nodes and be reused after erase
+void test_small_tree(const size_t n, const size_t pool, const unsigned int seed) {
+  srand(seed);
+  rbtree *t = new_rbtree_small(pool);
+  rbtree *u = new_rbtree();
+  assert(t->nil == u->nil);
+  delete_rbtree(u);
+
+  key_t *arr = calloc(n, sizeof(key_t));
+  for (size_t i = 0; i < n; i++) {
+    arr[i] = rand() % (n / 2);
+    node_t *p = rbtree_insert(t, arr[i]);
+    const bool pooled = p >= t->pool && p < t->pool + pool;
+    assert(pooled == (i < pool));
+  }
+  check_to_array(t, arr, n);
+
+  // erased pool nodes come back before any heap node
+  size_t live = n;
+  for (size_t i = 0; i < pool / 2; i++) {
+    node_t *p = &t->pool[rand() % pool];
+    for (size_t j = 0; j < live; j++) {
+      if (arr[j] == p->key) {
+        arr[j] = arr[--live];
+        break;
+      }
+    }
+    assert(rbtree_erase(t, p) == 0);
+
+    const key_t key = rand() % (n / 2);
+    node_t *q = rbtree_insert(t, key);
+    assert(q == p);
+    arr[live++] = key;
+  }
+
+  while (live > 0) {
+    const size_t victim = rand() % live;
+    node_t *p = rbtree_find(t, arr[victim]);
+    assert(p != NULL);
+    assert(rbtree_erase(t, p) == 0);
+    arr[victim] = arr[--live];
+    if (live % 7 == 0) {
+      check_to_array(t, arr, live);
+      test_color_constraint(t);
+      test_search_constraint(t);
+    }
+  }
+  assert(t->root == t->nil);
+
+  // the shared sentinel is never written
+  assert(t->nil->color == RBTREE_BLACK);
+  assert(t->nil->parent == NULL && t->nil->left == NULL && t->nil->right == NULL);
+#ifdef RBTREE_INTERVAL
+  assert(t->nil->max == INT_MIN);
+#endif
+
+  for (size_t i = 0; i < n; i++) {
+    rbtree_insert(t, (key_t)i);
+  }
+  free(arr);
+  delete_rbtree(t);
+}
+
+static bool same_shape(const rbtree *t, const node_t *p, const rbtree *u, const node_t *q) {
+  if (p == t->nil || q == u->nil) {
+    return p == t->nil && q == u->nil;
+  }
+#ifdef RBTREE_INTERVAL
+  if (p->hi != q->hi || p->max != q->max) {
+    return false;
+  }
+#endif
+  return p != q && p->key == q->key && p->color == q->color && p->dead == q->dead &&
+         same_shape(t, p->left, u, q->left) && same_shape(t, p->right, u, q->right);
+}
+
+// a clone should copy the shape exactly and stay independent of the original
+void test_clone(const size_t n, const unsigned int seed) {
+  srand(seed);
+  rbtree *t = new_rbtree();
+  assert(rbtree_set_lazy_erase(t, 0.5) == 0);
+  assert(rbtree_set_find_cache(t, 64) == 0);
+
+  key_t *arr = calloc(n, sizeof(key_t));
+  for (size_t i = 0; i < n; i++) {
+    arr[i] = rand() % (n / 2);
+    rbtree_insert(t, arr[i]);
+  }
+  size_t live = n;
+  for (size_t i = 0; i < n / 5; i++) {
+    const size_t victim = rand() % live;
+    rbtree_erase(t, rbtree_find(t, arr[victim]));
+    arr[victim] = arr[--live];
+  }
+  assert(t->dead > 0);
+  assert(rbtree_set_insert_buffer(t, 16) == 0);
+  for (size_t i = 0; i < 8; i++) {
+    arr[live] = rand() % (n / 2);
+    rbtree_insert(t, arr[live++]);
+  }
+
+  rbtree *c = rbtree_clone(t);
+  assert(c != NULL);
+  assert(same_shape(t, t->root, c, c->root));
+  assert(c->size == t->size && c->dead == t->dead && c->buf_len == t->buf_len);
+  assert(c->cache != NULL && c->cache->hits == 0);
+  for (size_t i = 0; i < c->buf_len; i++) {
+    assert(c->buf[i] != t->buf[i] && c->buf[i]->key == t->buf[i]->key && c->buf_keys[i] == t->buf_keys[i]);
+  }
+  check_to_array(c, arr, live);
+  test_color_constraint(c);
+  test_search_constraint(c);
+
+  // erasing everything from the clone leaves the original intact
+  for (size_t i = 0; i < live; i++) {
+    assert(rbtree_erase(c, rbtree_find(c, arr[i])) == 0);
+  }
+  assert(rbtree_min(c) == NULL);
+  check_to_array(t, arr, live);
+  rbtree_insert(c, 1);
+
+  free(arr);
+  delete_rbtree(c);
+  delete_rbtree(t);
+
+  // byte-key nodes are larger than node_t, so they are refused rather than truncated
+  t = new_rbtree();
+  rbtree_insert_bytes(t, "https://example.com/", 20);
+  rbtree_insert_bytes(t, "ab", 2);
+  assert(rbtree_clone(t) == NULL);
+  assert(rbtree_find_bytes(t, "https://example.com/", 20) != NULL);
+  delete_rbtree(t);
+}
+
+// incremental teardown should do bounded work per call and release everything
+void test_delete_incremental(const size_t n, const size_t budget, const unsigned int seed) {
+  srand(seed);
+  rbtree *t = new_rbtree_small(n / 4);
+  assert(rbtree_set_find_cache(t, 32) == 0);
+  for (size_t i = 0; i < n; i++) {
+    rbtree_insert(t, rand() % n);
+  }
+  assert(rbtree_set_insert_buffer(t, 16) == 0);
+  for (size_t i = 0; i < 8; i++) {
+    rbtree_insert(t, rand() % n);
+  }
+
+  // every node is freed once and rotated into the list at most once
+  size_t calls = 1;
+  while (rbtree_delete_incremental(t, budget)) {
+    calls++;
+    assert(calls <= 2 * n / budget + 1);
+  }
+  assert(calls >= n / budget);
+
+  // budget 0 on an empty tree still releases it
+  assert(rbtree_delete_incremental(new_rbtree(), 0) == 0);
+}
+
+// compaction should keep the shape, lay nodes out in order and leave the tree mutable
+void test_compact(const size_t n, const unsigned int seed) {
+  srand(seed);
+  rbtree *t = new_rbtree_small(16);
+  assert(rbtree_set_find_cache(t, 32) == 0);
+  key_t *arr = calloc(n, sizeof(key_t));
+  for (size_t i = 0; i < n; i++) {
+    arr[i] = rand() % (n / 2);
+    rbtree_insert(t, arr[i]);
+  }
+  size_t live = n;
+  for (size_t i = 0; i < n / 3; i++) {
+    const size_t victim = rand() % live;
+    rbtree_erase(t, rbtree_find(t, arr[victim]));
+    arr[victim] = arr[--live];
+  }
+
+  for (int round = 0; round < 2; round++) {
+    rbtree *c = rbtree_clone(t);
+    assert(rbtree_compact(t) == 0);
+    assert(same_shape(c, c->root, t, t->root));
+    delete_rbtree(c);
+
+    assert(t->pool_cap == live);
+    size_t i = 0;
+    for (node_t *p = rbtree_min(t); i < live; i++) {
+      assert(p == &t->pool[i]);
+      if (p->right != t->nil) {
+        for (p = p->right; p->left != t->nil; p = p->left) {
+        }
+      } else {
+        while (p->parent != t->nil && p == p->parent->right) {
+          p = p->parent;
+        }
+        p = p->parent;
+      }
+    }
+    check_to_array(t, arr, live);
+
+    // keep churning on the compacted tree
+    for (size_t j = 0; j < n / 4; j++) {
+      const size_t victim = rand() % live;
+      node_t *p = rbtree_find(t, arr[victim]);
+      assert(p != NULL && p->key == arr[victim]);
+      assert(rbtree_erase(t, p) == 0);
+      arr[victim] = rand() % (n / 2);
+      rbtree_insert(t, arr[victim]);
+    }
+    check_to_array(t, arr, live);
+    test_color_constraint(t);
+    test_search_constraint(t);
+  }
+
+  for (size_t i = 0; i < live; i++) {
+    assert(rbtree_erase(t, rbtree_find(t, arr[i])) == 0);
+  }
+  assert(rbtree_compact(t) == 0);
+  assert(t->root == t->nil);
+  rbtree_insert(t, 1);
+
+  free(arr);
+  delete_rbtree(t);
+
+  // byte-key trees are left untouched
+  t = new_rbtree();
+  node_t *a = rbtree_insert_bytes(t, "https://example.com/", 20);
+  node_t *b = rbtree_insert_bytes(t, "ab", 2);
+  node_t *root = t->root;
+  assert(rbtree_compact(t) == -1);
+  assert(t->root == root && t->pool_cap == 0);
+  assert(rbtree_find_bytes(t, "https://example.com/", 20) == a && rbtree_find_bytes(t, "ab", 2) == b);
+  delete_rbtree(t);
+}
+#endif  // RBTREE_BTREE, RBTREE_NOPARENT
+
 int main(void) {
   test_init();
+#if !defined(RBTREE_BTREE) && !defined(RBTREE_NOPARENT)
   test_insert_single(1024);
+#endif
   test_find_single(512, 1024);
+#ifndef RBTREE_BTREE
   test_erase_root(128);
+#endif
   test_find_erase_fixed();
   test_minmax_suite();
   test_to_array_suite();
+#ifndef RBTREE_BTREE
   test_distinct_values();
   test_duplicate_values();
+  test_erase_constraints_rand(500, 23);
+#endif
   test_multi_instance();
   test_find_erase_rand(10000, 17);
+  test_erase_duplicates_rand(5000, 19);
+  test_hook();
+#if !defined(RBTREE_BTREE) && !defined(RBTREE_NOPARENT)
+#ifdef RBTREE_INTERVAL
+  test_interval_rand(10000, 29);
+#endif
+  test_lazy_erase(4000, 31);
+  test_bytes_keys(2000, 37);
+  test_insert_buffer(3000, 64, 41);
+  test_find_cache(2000, 43);
+  test_small_tree(500, 16, 47);
+  test_clone(2000, 53);
+  test_delete_incremental(3000, 7, 59);
+  test_compact(3000, 61);
+#endif
   printf("Passed all tests!\n");
 }